@@ -4,16 +4,27 @@
 #define BINARYPQ_H
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 #include "Eecs281PQ.h"
+#include "HeapCore.h"
+#include "PQStats.h"
 
 // A specialized version of the 'heap' ADT implemented as a binary heap.
-template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class BinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>
+// The number of children per node is fixed at compile time by ARITY; wider
+// heaps are shallower and keep each group of siblings close together in
+// memory, at the cost of more comparisons per level in fixDown().  The
+// sifts themselves are HeapCore's.
+// STATS is the stats policy; see PQStats.h.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t ARITY = 2,
+          typename STATS = NoStats>
+class BinaryPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS>
 {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
+    using Core = HeapCore<ARITY>;
+
 public:
     // Description: Construct an empty heap with an optional comparison functor.
     // Runtime: O(1)
@@ -28,8 +39,9 @@ public:
     BinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
         : BaseClass{comp}, data{start, end}
     {
-        updatePriorities();
-
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(size());
+        heapify();
     } // BinaryPQ
 
     // Description: Destructor doesn't need any code, the data vector will
@@ -43,25 +55,99 @@ public:
     // Runtime: O(n)
     virtual void updatePriorities()
     {
-        std::size_t i = size() - 1;
-        while (i > 0)
-        {
-
-            fixDown(i);
-            i--;
-        }
-        fixDown(0);
+        this->counters().begin(PQOp::Update);
+        heapify();
+    } // updatePriorities()
 
+    // Description: Restore the heap invariant after the priorities of the
+    //              elements for which 'changed' returns true have changed in
+    //              place, in either direction.  Only those elements and their
+    //              ancestors are sifted down, deepest first, so each sift
+    //              starts above subheaps that are already valid.  When that
+    //              would touch a large part of the heap, it is rebuilt as by
+    //              updatePriorities() instead.
+    // Runtime: O(n) calls to 'changed', plus O(k log^2(n)) comparisons where
+    //          k is the number of changed elements, or O(n) for a rebuild.
+    template <typename Predicate>
+    void updatePriorities(Predicate changed)
+    {
+        this->counters().begin(PQOp::Update);
+        std::vector<std::size_t> dirty;
+        for (std::size_t i = 0; i < size(); ++i)
+            if (changed(data[i]))
+                dirty.push_back(i);
+        Core::repair(slots(), dirty);
     } // updatePriorities()
 
     // Description: Add a new element to the heap.
     // Runtime: O(log(n))
     virtual void push(const TYPE &val)
     {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
         data.push_back(val);
         fixUp(size() - 1);
     } // push()
 
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: O(log(n))
+    virtual void push(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(std::move(val));
+        fixUp(size() - 1);
+    } // push()
+
+    // Description: Construct a new element in place at the back of the heap
+    //              from 'args', then fix the heap invariant.
+    // Runtime: O(log(n))
+    template <typename... Args>
+    void emplace(Args &&... args)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.emplace_back(std::forward<Args>(args)...);
+        fixUp(size() - 1);
+    } // emplace()
+
+    // Description: Add every element of the range [first, last) to the heap.
+    //              The new elements are appended, then either sifted up one at
+    //              a time or the whole heap is rebuilt, whichever has the
+    //              smaller worst case: about m * depth comparisons for the
+    //              sifts against about 2(n + m) for the rebuild.
+    // Runtime: O(min(m log(n + m), n + m)) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::size_t old = size();
+        data.insert(data.end(), first, last);
+        this->counters().moved(size() - old);
+        Core::siftAppended(slots(), old);
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this heap, leaving
+    //              'other' empty.  If this heap is empty the two simply trade
+    //              storage; otherwise the elements are added as by
+    //              pushRange(), which rebuilds the heap when that is cheaper.
+    // Runtime: O(min(m log(n + m), n + m)) where m is other.size().
+    void merge(BinaryPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        if (empty())
+        {
+            this->counters().begin(PQOp::Bulk);
+            data.swap(other.data);
+        }
+        else
+            pushRange(std::make_move_iterator(other.data.begin()),
+                      std::make_move_iterator(other.data.end()));
+        other.data.clear();
+    } // merge()
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the heap.
     // Note: We will not run tests on your code that would require it to pop an
@@ -70,12 +156,86 @@ public:
     // Runtime: O(log(n))
     virtual void pop()
     {
-        data[0] = data.back();
-        data.pop_back();
-        if (!empty())
-            fixDown(0);
+        this->counters().begin(PQOp::Pop);
+        removeTop();
     } // pop()
 
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: O(log(n))
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(data[0]);
+        removeTop();
+        return val;
+    } // popTop()
+
+    // Description: Replace the most extreme element with 'val' and restore
+    //              the heap invariant with a single sift down, which costs
+    //              less than a pop() followed by a push().  The heap must not
+    //              be empty.
+    // Runtime: O(log(n))
+    void replaceTop(const TYPE &val)
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        data[0] = val;
+        Core::fixDown(slots(), 0);
+    } // replaceTop()
+
+    // Description: Replace the most extreme element with 'val', moving from
+    //              it, and restore the heap invariant with a single sift down.
+    // Runtime: O(log(n))
+    void replaceTop(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        data[0] = std::move(val);
+        Core::fixDown(slots(), 0);
+    } // replaceTop()
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  The heap is sorted in place (heapsort, with the
+    //              same bottom-up sift as pop()) and then moved out in one
+    //              pass, instead of being popped n times.  Returns the
+    //              output iterator past the last element written.  The
+    //              storage is kept for reuse.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        this->counters().moved(size());
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        return out;
+    } // drainSorted()
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them.  The heap's own storage is
+    //              sorted in place and handed over, so nothing is moved.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        return sorted;
+    } // extractSorted()
+
+    // Description: Make room for 'n' elements, so the heap does not allocate
+    //              again until it holds more than that.
+    // Runtime: O(n) if storage is reallocated, otherwise O(1)
+    void reserve(std::size_t n)
+    {
+        data.reserve(n);
+    } // reserve()
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the heap.  This should be a reference for speed.  It MUST be
     //              const because we cannot allow it to be modified, as that
@@ -83,8 +243,8 @@ public:
     // Runtime: O(1)
     virtual const TYPE &top() const
     {
+        this->counters().begin(PQOp::Top);
         return data[0];
-
     } // top()
 
     // Description: Get the number of elements in the heap.
@@ -101,38 +261,85 @@ public:
         return (data.size() == 0);
     } // empty()
 
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
 private:
     // Note: This vector *must* be used your heap implementation.
     std::vector<TYPE> data;
 
+
     // TODO: Add any additional member functions or data you require here.
     // For instance, you might add fixUp() and fixDown().
 
+    // this->compare, reported to the stats policy.
+    bool lower(const TYPE &a, const TYPE &b) const
+    {
+        this->counters().compared();
+        return this->compare(a, b);
+    }
+
+    // HeapCore's view of 'data'.
+    struct Slots
+    {
+        using Entry = TYPE;
+
+        BinaryPQ &pq;
+
+        std::size_t size() const { return pq.data.size(); }
+        bool lower(std::size_t i, std::size_t j) const { return pq.lower(pq.data[i], pq.data[j]); }
+        bool lowerThan(std::size_t i, const TYPE &val) const { return pq.lower(pq.data[i], val); }
+        bool lowerEntry(const TYPE &val, std::size_t i) const { return pq.lower(val, pq.data[i]); }
+        TYPE take(std::size_t k) const { return std::move(pq.data[k]); }
+        void put(std::size_t k, TYPE &&val) const { pq.data[k] = std::move(val); }
+        void shift(std::size_t to, std::size_t from) const { pq.data[to] = std::move(pq.data[from]); }
+        void moved(std::size_t n) const { pq.counters().moved(n); }
+        void sifted(std::size_t levels) const { pq.counters().sifted(levels); }
+    }; // Slots
+
+    Slots slots()
+    {
+        return Slots{*this};
+    }
+
     void fixUp(std::size_t k)
     {
-        while (k > 0 && this->compare(data[(k - 1) / 2], data[k]))
-        {
-            std::swap(data[(k - 1) / 2], data[k]);
-            k = (k - 1) / 2;
-        }
+        Core::fixUp(slots(), k);
     }
 
-    void fixDown(std::size_t k)
+    void heapify()
     {
+        Core::heapify(slots());
+    }
 
-        while (2 * k + 1 <= size() - 1)
-        {
-            std::size_t j = 2 * k + 1;
-            if (j < size() - 1 && this->compare(data[j], data[j + 1]))
-                j++;
-            if (this->compare(data[j], data[k]))
-                break;
-
-            std::swap(data[k], data[j]);
-            k = j;
-        }
+    // Remove the root by moving the back element into its place.
+    void removeTop()
+    {
+        TYPE val = std::move(data.back());
+        data.pop_back();
+        this->counters().moved();
+        if (!empty())
+            Core::dropInto(slots(), std::move(val), size());
     }
 
 }; // BinaryPQ
 
+// A d-ary heap is a BinaryPQ with a wider fan-out; 4 children per node keeps
+// a node's children within one cache line for small keys.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t ARITY = 4,
+          typename STATS = NoStats>
+using DaryPQ = BinaryPQ<TYPE, COMP_FUNCTOR, ARITY, STATS>;
+
 #endif // BINARYPQ_H
@@ -0,0 +1,368 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef BLOCKEDUNORDEREDPQ_H
+#define BLOCKEDUNORDEREDPQ_H
+
+#include "Eecs281PQ.h"
+#include "ExtremeScan.h"
+#include "PQStats.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+
+// A variant of UnorderedFastPQ that keeps a summary of its unordered array,
+// so a pop no longer has to scan all of it.  'data' is split into blocks of
+// BLOCK consecutive elements, and best[b] holds the index of the most
+// extreme element of block b.  A push lands in the last block and updates
+// its summary with a single comparison; finding the most extreme element
+// scans only the n / BLOCK summaries; and a pop, which moves the back
+// element into the hole, rescans only the block it popped from (and the
+// last block, if that lost its most extreme element).  That makes a pop
+// O(BLOCK + n / BLOCK), O(sqrt(n)) for BLOCK near sqrt(n), between the
+// O(n) of the unordered queues and the O(log(n)) of BinaryPQ, while a push
+// stays O(1).  Blocks are rescanned with the same (vectorized, for
+// arithmetic keys) scan as UnorderedFastPQ; see ExtremeScan.h.
+
+// As in UnorderedFastPQ, the index of the most extreme element is remembered
+// once found, so a pop() after a top() does not search again.  Unlike there,
+// a push does not forget it: a push that does not beat its block's summary
+// cannot beat it either, and one that does is compared with it as well.
+
+// STATS is the stats policy; see PQStats.h.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t BLOCK = 512,
+         typename STATS = NoStats>
+class BlockedUnorderedPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS> {
+    static_assert(BLOCK >= 1, "a block needs at least one element");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+public:
+    // Description: Construct an empty heap with an optional comparison functor.
+    // Runtime: O(1)
+    explicit BlockedUnorderedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp }, extreme{ NONE } {
+    } // BlockedUnorderedPQ()
+
+
+    // Description: Construct a heap out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    BlockedUnorderedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp }, data{ start, end }, extreme{ NONE } {
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(data.size());
+        summarizeFrom(0);
+    } // BlockedUnorderedPQ()
+
+
+    // Description: Destructor doesn't need any code, the vectors will be
+    //              destroyed automatically.
+    virtual ~BlockedUnorderedPQ() {
+    } // ~BlockedUnorderedPQ()
+
+
+    // Description: Rescan every block, since any element may have changed.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        this->counters().begin(PQOp::Update);
+        extreme = NONE;
+        for (std::size_t b = 0; b < best.size(); ++b)
+            rescan(b);
+    } // updatePriorities()
+
+
+    // Description: Rescan only the blocks holding an element for which
+    //              'changed' returns true.
+    // Runtime: O(n) calls to 'changed', plus O(k * BLOCK) where k is the
+    //          number of blocks rescanned.
+    template<typename Predicate>
+    void updatePriorities(Predicate changed) {
+        this->counters().begin(PQOp::Update);
+        extreme = NONE;
+        for (std::size_t b = 0; b < best.size(); ++b) {
+            std::size_t last = std::min(data.size(), (b + 1) * BLOCK);
+            for (std::size_t i = b * BLOCK; i < last; ++i)
+                if (changed(data[i])) {
+                    rescan(b);
+                    break;
+                } // if
+        } // for
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the heap.
+    // Runtime: Amortized O(1)
+    virtual void push(const TYPE &val) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(val);
+        summarizeBack();
+    } // push()
+
+
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(std::move(val));
+        summarizeBack();
+    } // push()
+
+
+    // Description: Construct a new element in place at the back of the heap.
+    // Runtime: Amortized O(1)
+    template<typename... Args>
+    void emplace(Args &&... args) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.emplace_back(std::forward<Args>(args)...);
+        summarizeBack();
+    } // emplace()
+
+
+    // Description: Add every element of the range [first, last) to the heap,
+    //              then summarize the blocks they landed in.
+    // Runtime: O(m + BLOCK) where m is number of elements in range.
+    template<typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last) {
+        this->counters().begin(PQOp::Bulk);
+        std::size_t old = data.size();
+        data.insert(data.end(), first, last);
+        this->counters().moved(data.size() - old);
+        extreme = NONE;
+        summarizeFrom(old);
+    } // pushRange()
+
+
+    // Description: Move every element of 'other' into this heap, leaving
+    //              'other' empty.
+    // Runtime: O(m + BLOCK) where m is other.size(), or O(1) if this heap is
+    //          empty.
+    void merge(BlockedUnorderedPQ &&other) {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        if (data.empty()) {
+            data.swap(other.data);
+            best.swap(other.best);
+        }
+        else {
+            std::size_t old = data.size();
+            this->counters().moved(other.data.size());
+            data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                        std::make_move_iterator(other.data.end()));
+            summarizeFrom(old);
+        }
+        other.data.clear();
+        other.best.clear();
+        extreme = NONE;
+        other.extreme = NONE;
+    } // merge()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the heap.
+    // Runtime: O(BLOCK + n / BLOCK)
+    virtual void pop() {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        if (extreme == NONE)
+            findExtreme();
+        removeExtreme();
+    } // pop()
+
+
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: O(BLOCK + n / BLOCK)
+    virtual TYPE popTop() {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved(2);
+        if (extreme == NONE)
+            findExtreme();
+
+        TYPE val = std::move(data[extreme]);
+        removeExtreme();
+        return val;
+    } // popTop()
+
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  'data' is sorted in place and moved out in one
+    //              pass.  Returns the output iterator past the last element
+    //              written.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out) {
+        this->counters().begin(PQOp::Bulk);
+        sortData();
+        this->counters().moved(data.size());
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        return out;
+    } // drainSorted()
+
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them, by sorting 'data' in place and
+    //              handing it over.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() && {
+        this->counters().begin(PQOp::Bulk);
+        sortData();
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        return sorted;
+    } // extractSorted()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(n / BLOCK), or O(1) if it is already known.
+    virtual const TYPE &top() const {
+        this->counters().begin(PQOp::Top);
+        if (extreme == NONE)
+            findExtreme();
+        return elementAt(data, extreme);
+    } // top()
+
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return data.size();
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return data.empty();
+    } // empty()
+
+
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const {
+        return this->counters();
+    } // stats()
+
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats() {
+        this->counters().reset();
+    } // resetStats()
+
+
+private:
+    std::vector<TYPE> data;
+
+    // best[b] is the index in 'data' of the most extreme element of block b,
+    // data[b * BLOCK, (b + 1) * BLOCK).  Every block but the last is full.
+    std::vector<std::size_t> best;
+
+
+    // The index of the most extreme element, or NONE.
+    mutable std::size_t extreme;
+
+    // this->compare, reported to the stats policy.
+    bool lower(const TYPE &a, const TYPE &b) const {
+        this->counters().compared();
+        return this->compare(a, b);
+    }
+
+
+    // Description: Fold the element just pushed onto the back into the last
+    //              block's summary, starting a new block if it is the first
+    //              in one.  Only a new block summary can beat the known most
+    //              extreme element, so only then is it compared with that.
+    // Runtime: O(1)
+    void summarizeBack() {
+        std::size_t i = data.size() - 1;
+        if (i % BLOCK == 0)
+            best.push_back(i);
+        else if (lower(data[best.back()], data[i]))
+            best.back() = i;
+        else
+            return;
+        if (extreme != NONE && lower(data[extreme], data[i]))
+            extreme = i;
+    } // summarizeBack()
+
+
+    // Description: Find the most extreme element by scanning the summaries.
+    // Runtime: O(n / BLOCK)
+    void findExtreme() const {
+        this->counters().scanned(best.size());
+        std::size_t index = best[0];
+        for (std::size_t b = 1; b < best.size(); ++b)
+            if (lower(data[index], data[best[b]]))
+                index = best[b];
+        extreme = index;
+    } // findExtreme()
+
+
+    // Description: Recompute the summary of block b.
+    // Runtime: O(BLOCK)
+    void rescan(std::size_t b) {
+        std::size_t first = b * BLOCK;
+        std::size_t length = std::min(BLOCK, data.size() - first);
+        this->counters().scanned(length);
+        best[b] = first + extremeIndex(data, first, length,
+                                       PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+    } // rescan()
+
+
+    // Description: Summarize every block from the one holding data[from]
+    //              onwards, after elements were appended from there.
+    // Runtime: O(m + BLOCK) where m is size() - from
+    void summarizeFrom(std::size_t from) {
+        std::size_t blocks = (data.size() + BLOCK - 1) / BLOCK;
+        best.resize(blocks);
+        for (std::size_t b = from / BLOCK; b < blocks; ++b)
+            rescan(b);
+    } // summarizeFrom()
+
+
+    // Description: Remove data[extreme] by moving the back element into its
+    //              place, then repair the summaries of the block it was in
+    //              and of the last block, the only two that changed.
+    // Runtime: O(BLOCK)
+    void removeExtreme() {
+        std::size_t last = data.size() - 1;
+        std::size_t hole = extreme / BLOCK;
+        std::size_t tail = last / BLOCK;
+        if (extreme != last)
+            data[extreme] = std::move(data[last]);
+        data.pop_back();
+        extreme = NONE;
+
+        if (last % BLOCK == 0)
+            best.pop_back();
+        if (hole < best.size())
+            rescan(hole);
+        if (tail != hole && tail < best.size() && best[tail] == last)
+            rescan(tail);
+    } // removeExtreme()
+
+
+    // Description: Sort the data vector in ascending order by 'compare', and
+    //              forget the summaries, as the caller empties it.
+    // Runtime: O(n log(n))
+    void sortData() {
+        std::sort(data.begin(), data.end(), PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+        best.clear();
+        extreme = NONE;
+    } // sortData()
+}; // BlockedUnorderedPQ
+
+#endif // BLOCKEDUNORDEREDPQ_H
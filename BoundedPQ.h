@@ -0,0 +1,140 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef BOUNDEDPQ_H
+#define BOUNDEDPQ_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "BinaryPQ.h"
+
+// The comparison functor a BoundedPQ hands to its heap: 'compare' with the
+// arguments swapped, so the top of the heap is the least extreme element.
+template <typename TYPE, typename COMP_FUNCTOR>
+struct InvertedCompare
+{
+    COMP_FUNCTOR compare;
+
+    bool operator()(const TYPE &a, const TYPE &b) const
+    {
+        return compare(b, a);
+    }
+}; // InvertedCompare
+
+// Keeps the k most extreme (defined by 'compare') elements of a stream of
+// any length, in O(k) memory: with std::less, the k largest.  They are held
+// in a BinaryPQ ordered by InvertedCompare, whose top is the least extreme
+// element kept, the one a better newcomer evicts.  Once the queue is full,
+// a newcomer that is not more extreme than that costs a single comparison
+// to turn away, and one that is replaces it in place with a single sift.
+// All storage is reserved by the constructor, so pushes never allocate.
+//
+// The elements come back out through drainSorted(), in the same order as
+// from the queues' drainSorted(): ascending, so the best comes last.  Since
+// it only ever gives up its least extreme element, this is not an
+// Eecs281PQ.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class BoundedPQ
+{
+public:
+    // Description: Construct an empty queue that keeps up to 'capacity'
+    //              elements, with an optional comparison functor.
+    // Runtime: O(capacity) to reserve the storage
+    explicit BoundedPQ(std::size_t capacity, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : heap{InvertedCompare<TYPE, COMP_FUNCTOR>{comp}}, compare{comp}, limit{capacity}
+    {
+        heap.reserve(capacity);
+    } // BoundedPQ()
+
+    // Description: Offer 'val' to the queue.  Returns true if it was kept,
+    //              evicting the least extreme element if the queue was full,
+    //              and false if it was turned away.  Ties with the least
+    //              extreme element are turned away.
+    // Runtime: O(1) if turned away, otherwise O(log(capacity))
+    bool push(const TYPE &val)
+    {
+        return offer(val);
+    } // push()
+
+    // Description: Offer 'val' to the queue, moving from it if it is kept.
+    // Runtime: O(1) if turned away, otherwise O(log(capacity))
+    bool push(TYPE &&val)
+    {
+        return offer(std::move(val));
+    } // push()
+
+    // Description: Return the least extreme element kept, which once the
+    //              queue is full is the bar a newcomer has to beat.  The
+    //              queue must not be empty.
+    // Runtime: O(1)
+    const TYPE &threshold() const
+    {
+        return heap.top();
+    } // threshold()
+
+    // Description: Empty the queue into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  That is the order the inverted heap pops in, so
+    //              the elements are popped straight out; that costs the same
+    //              sifts as a heapsort and keeps the storage reserved, so the
+    //              queue can be reused without allocating.  Returns the
+    //              output iterator past the last element written.
+    // Runtime: O(k log(k)) where k is size()
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        while (!heap.empty())
+            *out++ = heap.popTop();
+        return out;
+    } // drainSorted()
+
+    // Description: Get the number of elements kept.
+    // Runtime: O(1)
+    std::size_t size() const
+    {
+        return heap.size();
+    } // size()
+
+    // Description: Get the most elements the queue will keep.
+    // Runtime: O(1)
+    std::size_t capacity() const
+    {
+        return limit;
+    } // capacity()
+
+    // Description: Return true if no element is kept.
+    // Runtime: O(1)
+    bool empty() const
+    {
+        return heap.empty();
+    } // empty()
+
+    // Description: Return true if the queue holds 'capacity' elements, so
+    //              every further push() is a comparison with threshold().
+    // Runtime: O(1)
+    bool full() const
+    {
+        return heap.size() == limit;
+    } // full()
+
+private:
+    BinaryPQ<TYPE, InvertedCompare<TYPE, COMP_FUNCTOR>> heap;
+    COMP_FUNCTOR compare;
+    std::size_t limit;
+
+    template <typename T>
+    bool offer(T &&val)
+    {
+        if (heap.size() == limit)
+        {
+            if (limit == 0 || !compare(heap.top(), val))
+                return false;
+            heap.replaceTop(std::forward<T>(val));
+            return true;
+        }
+        heap.push(std::forward<T>(val));
+        return true;
+    }
+}; // BoundedPQ
+
+#endif // BOUNDEDPQ_H
@@ -3,12 +3,21 @@
 #ifndef EECS281_PQ_H
 #define EECS281_PQ_H
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 // A simple interface that implements a generic priority queue.
 // Runtime specifications assume constant time comparison and copying.
+//
+// Every implementation is declared 'final', so code that holds a concrete
+// queue (or takes its type as a template parameter) calls its members
+// directly, and the compiler can inline them and 'compare' into the caller.
+// Only calls made through an Eecs281PQ pointer or reference go through the
+// virtual functions below; use it where the choice of queue is made at run
+// time.
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
 class Eecs281PQ {
 public:
@@ -17,6 +26,51 @@ public:
     // Description: Add a new element to the priority queue.
     virtual void push(const TYPE &val) = 0;
 
+    // Description: Add a new element to the priority queue, moving from 'val'
+    //              instead of copying it.
+    virtual void push(TYPE &&val) = 0;
+
+    // Description: Construct a new element from 'args' and add it to the
+    //              priority queue.  Derived classes that can construct the
+    //              element directly in their own storage hide this version.
+    template<typename... Args>
+    void emplace(Args &&... args) {
+        push(TYPE(std::forward<Args>(args)...));
+    }
+
+    // Description: Add every element of the range [first, last) to the
+    //              priority queue.  Derived classes with a faster bulk path
+    //              hide this version.
+    template<typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last) {
+        for (; first != last; ++first)
+            push(*first);
+    }
+
+    // Description: Empty the priority queue into 'out' in sorted order,
+    //              ascending as defined by 'compare', so the most extreme
+    //              element comes last.  Returns the output iterator past the
+    //              last element written.  This version goes through
+    //              extractSorted(); derived classes with a faster path hide
+    //              both.
+    template<typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out) {
+        std::vector<TYPE> sorted = std::move(*this).extractSorted();
+        return std::move(sorted.begin(), sorted.end(), out);
+    }
+
+    // Description: Empty the priority queue and return its elements in the
+    //              order drainSorted() writes them.  This version pops every
+    //              element and reverses the result.
+    std::vector<TYPE> extractSorted() && {
+        std::vector<TYPE> sorted;
+        sorted.reserve(size());
+        while (!empty())
+            sorted.push_back(popTop());
+        std::reverse(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the priority queue.
     // Note: We will not run tests on your code that would require it to pop an
@@ -24,6 +78,11 @@ public:
     // familiar with them, you do not need to use exceptions in this project.
     virtual void pop() = 0;
 
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the priority queue and return it, moving it out instead of
+    //              copying it.
+    virtual TYPE popTop() = 0;
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the priority queue.
     virtual const TYPE &top() const = 0;
@@ -0,0 +1,457 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef EXTERNALPQ_H
+#define EXTERNALPQ_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BinaryPQ.h"
+#include "Eecs281PQ.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+// What an ExternalPQ has done with its temporary files.
+struct ExternalIOStats
+{
+    std::size_t runsWritten; // sorted runs spilled from the insertion buffer
+    std::size_t mergePasses; // times the runs of one level were merged into one
+    std::size_t runsMerged;  // runs consumed by those merges
+    std::size_t maxRuns;     // most runs open at the same time
+    std::size_t writes;      // blocks written
+    std::size_t reads;       // blocks read
+    std::size_t bytesWritten;
+    std::size_t bytesRead;
+}; // ExternalIOStats
+
+// A priority queue for more elements than fit in memory, after the sequence
+// heap of Sanders.  New elements go into an in-memory BinaryPQ, the
+// insertion buffer.  When that reaches its share of the memory budget, it is
+// drained in order into a sorted run in a temporary file.  Each run keeps
+// one block of its elements in memory, and the first element of every run
+// sits in a second BinaryPQ, so top() is the better of the two heaps' tops,
+// and pop() takes from one of them, reading a run's next block once its
+// current one is used up.  Runs are read strictly in sequence, and the
+// operating system is told to start fetching the next block of a run as
+// soon as the current one is read.
+//
+// When the number of runs would exceed what their blocks can share of the
+// budget, runs are merged, by level as in the sequence heap: a spilled run
+// is on level 0, and merging the runs of level i gives one run on level
+// i + 1.  The level merged is the one holding the most runs, so with L
+// levels in use each merge combines at least maxRuns / L runs, and an
+// element is rewritten once per level it climbs, O(log_(maxRuns / L)(n / B))
+// times for n elements and a buffer of B.  Merging everything instead would
+// rewrite all the runs each time, which is quadratic in n / B.
+//
+// Half of 'budget' (in bytes) goes to the insertion buffer and half to the
+// run blocks.  Temporary files come from std::tmpfile(), so they live in the
+// system's temporary directory and disappear when closed, even if the
+// program does not exit normally.  A failed read or write throws
+// std::runtime_error.
+//
+// Elements are written to disk byte for byte, so TYPE must be trivially
+// copyable, and anything it points to must outlive the queue.  The
+// drainSorted() and extractSorted() inherited from Eecs281PQ pop every
+// element into memory, so they are only for queues that fit there.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class ExternalPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>
+{
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "ExternalPQ writes its elements to disk byte for byte");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    static constexpr std::size_t DEFAULT_BUDGET = std::size_t{64} << 20;
+
+    // Description: Construct an empty queue that keeps about 'budget' bytes
+    //              of elements in memory, with an optional comparison functor.
+    // Runtime: O(1)
+    explicit ExternalPQ(std::size_t budget = DEFAULT_BUDGET, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass{comp}, buffer{comp}, heads{HeadComp{comp}}, count{0}, io{}
+    {
+        std::size_t half = std::max(budget / 2, sizeof(TYPE));
+        bufferLimit = half / sizeof(TYPE);
+        blockSize = std::max<std::size_t>(1, std::min(MAX_BLOCK_BYTES, half / MIN_RUNS) / sizeof(TYPE));
+        maxRuns = std::max<std::size_t>(2, half / (blockSize * sizeof(TYPE)));
+        // All of it up front, so the buffer never grows past its share by
+        // doubling.
+        buffer.reserve(bufferLimit);
+    } // ExternalPQ()
+
+    // Description: Construct a queue out of an iterator range, with a memory
+    //              budget and an optional comparison functor.
+    // Runtime: O(n log(n)) where n is number of elements in range.
+    template <typename InputIterator>
+    ExternalPQ(InputIterator start, InputIterator end, std::size_t budget = DEFAULT_BUDGET,
+               COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : ExternalPQ{budget, comp}
+    {
+        for (; start != end; ++start)
+            push(*start);
+    } // ExternalPQ()
+
+    ExternalPQ(const ExternalPQ &) = delete;
+    ExternalPQ &operator=(const ExternalPQ &) = delete;
+
+    // Description: Destructor doesn't need any code; each run closes, and so
+    //              deletes, its own file.
+    virtual ~ExternalPQ()
+    {
+    } // ~ExternalPQ()
+
+    // Description: Assumes that all elements are out of order, and sorts them
+    //              into new runs as if they were all pushed again.
+    // Runtime: O(n log(n)), reading and writing every element on disk once.
+    virtual void updatePriorities()
+    {
+        std::vector<TYPE> firsts;
+        while (!heads.empty())
+            firsts.push_back(heads.popTop().val);
+        std::vector<std::unique_ptr<Run>> old;
+        old.swap(runs);
+        freeSlots.clear();
+
+        buffer.updatePriorities();
+        for (const TYPE &val : firsts)
+            insert(val);
+        for (std::unique_ptr<Run> &run : old)
+        {
+            if (!run)
+                continue;
+            for (;;)
+            {
+                for (; run->next < run->block.size(); ++run->next)
+                    insert(run->block[run->next]);
+                if (run->unread == 0)
+                    break;
+                readBlock(*run);
+            }
+            run.reset();
+        }
+    } // updatePriorities()
+
+    // Description: Add a new element to the queue.
+    // Runtime: Amortized O(log(n)), plus amortized O(1) elements written.
+    virtual void push(const TYPE &val)
+    {
+        insert(val);
+        ++count;
+    } // push()
+
+    // Description: Add a new element to the queue; TYPE is trivially copyable,
+    //              so this is the same as push(const TYPE &).
+    // Runtime: Amortized O(log(n)), plus amortized O(1) elements written.
+    virtual void push(TYPE &&val)
+    {
+        insert(val);
+        ++count;
+    } // push()
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the queue.
+    // Note: We will not run tests on your code that would require it to pop an
+    // element when the queue is empty. Though you are welcome to if you are
+    // familiar with them, you do not need to use exceptions in this project.
+    // Runtime: O(log(n)), plus amortized O(1) elements read.
+    virtual void pop()
+    {
+        if (topInBuffer())
+            buffer.pop();
+        else
+            advance(heads.popTop().run);
+        --count;
+    } // pop()
+
+    // Description: Remove the most extreme element from the queue and return
+    //              it.
+    // Runtime: O(log(n)), plus amortized O(1) elements read.
+    virtual TYPE popTop()
+    {
+        if (topInBuffer())
+        {
+            --count;
+            return buffer.popTop();
+        }
+
+        Head head = heads.popTop();
+        advance(head.run);
+        --count;
+        return head.val;
+    } // popTop()
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the queue.
+    // Runtime: O(1)
+    virtual const TYPE &top() const
+    {
+        return topInBuffer() ? buffer.top() : heads.top().val;
+    } // top()
+
+    // Description: Get the number of elements in the queue, in memory and on
+    //              disk.
+    // Runtime: O(1)
+    virtual std::size_t size() const
+    {
+        return count;
+    } // size()
+
+    // Description: Return true if the queue is empty.
+    // Runtime: O(1)
+    virtual bool empty() const
+    {
+        return count == 0;
+    } // empty()
+
+    // Description: Return what the queue has read from and written to its
+    //              temporary files so far.
+    // Runtime: O(1)
+    const ExternalIOStats &ioStats() const
+    {
+        return io;
+    } // ioStats()
+
+private:
+    // Upper bound on the size of one run's block, and the number of runs
+    // the blocks should leave room for when the budget is small.
+    static constexpr std::size_t MAX_BLOCK_BYTES = std::size_t{1} << 20;
+    static constexpr std::size_t MIN_RUNS = 16;
+
+    // A sorted run in a temporary file, most extreme element first, and the
+    // block of it currently in memory.
+    struct Run
+    {
+        explicit Run(std::FILE *f) : file{f}, unread{0}, offset{0}, next{0}, level{0} {}
+        Run(const Run &) = delete;
+        Run &operator=(const Run &) = delete;
+        ~Run()
+        {
+            std::fclose(file);
+        }
+
+        std::FILE *file;
+        std::size_t unread;       // elements in the file not yet read
+        std::size_t offset;       // bytes of the file read so far
+        std::vector<TYPE> block;  // the elements read last
+        std::size_t next;         // index in 'block' of the run's next element
+        std::size_t level;        // merges its elements have been through
+    }; // Run
+
+    // The first element of a run not yet popped, and the run's slot.
+    struct Head
+    {
+        TYPE val;
+        std::size_t run;
+    }; // Head
+
+    struct HeadComp
+    {
+        COMP_FUNCTOR compare;
+
+        bool operator()(const Head &a, const Head &b) const
+        {
+            return compare(a.val, b.val);
+        }
+    }; // HeadComp
+
+    BinaryPQ<TYPE, COMP_FUNCTOR> buffer;
+    BinaryPQ<Head, HeadComp> heads;
+    std::vector<std::unique_ptr<Run>> runs; // empty slots are in freeSlots
+    std::vector<std::size_t> freeSlots;
+    std::size_t count;
+    std::size_t bufferLimit; // elements the insertion buffer may hold
+    std::size_t blockSize;   // elements per block read or written
+    std::size_t maxRuns;     // runs whose blocks fit in the budget
+    ExternalIOStats io;
+
+    // True if the most extreme element is in the insertion buffer rather
+    // than at the head of a run.
+    bool topInBuffer() const
+    {
+        return heads.empty() || (!buffer.empty() && !this->compare(buffer.top(), heads.top().val));
+    }
+
+    // Add an element to the insertion buffer, spilling it if it is full.
+    void insert(const TYPE &val)
+    {
+        buffer.push(val);
+        if (buffer.size() >= bufferLimit)
+            spill();
+    }
+
+    // Write the insertion buffer out as a new run on level 0, first merging
+    // runs already on disk if there is no room for another.
+    void spill()
+    {
+        if (runs.size() - freeSlots.size() >= maxRuns)
+            mergeLevel();
+
+        std::unique_ptr<Run> run = newRun();
+        std::vector<TYPE> out;
+        out.reserve(std::min(blockSize, buffer.size()));
+        while (!buffer.empty())
+        {
+            out.push_back(buffer.popTop());
+            if (out.size() == blockSize)
+                writeBlock(*run, out);
+        }
+        writeBlock(*run, out);
+        ++io.runsWritten;
+        addRun(std::move(run));
+    }
+
+    // Merge the runs of the level holding the most runs (the lowest, on a
+    // tie) into one run on the level above.  If no level holds two, which
+    // takes about 2^maxRuns buffers' worth of elements, every run is merged
+    // instead.  The heads of the runs merged are taken out of 'heads' and
+    // merged from a heap of their own.
+    void mergeLevel()
+    {
+        std::vector<std::size_t> perLevel;
+        for (const std::unique_ptr<Run> &run : runs)
+            if (run)
+            {
+                if (run->level >= perLevel.size())
+                    perLevel.resize(run->level + 1, 0);
+                ++perLevel[run->level];
+            }
+        std::size_t level = static_cast<std::size_t>(
+            std::max_element(perLevel.begin(), perLevel.end()) - perLevel.begin());
+        bool all = perLevel[level] < 2;
+        if (all)
+            level = perLevel.size() - 1;
+
+        BinaryPQ<Head, HeadComp> merging{HeadComp{this->compare}};
+        std::vector<Head> kept;
+        while (!heads.empty())
+        {
+            Head head = heads.popTop();
+            if (all || runs[head.run]->level == level)
+                merging.push(head);
+            else
+                kept.push_back(head);
+        }
+        heads.pushRange(kept.begin(), kept.end());
+
+        std::size_t merged = merging.size();
+        std::unique_ptr<Run> run = newRun();
+        run->level = level + 1;
+        std::vector<TYPE> out;
+        out.reserve(blockSize);
+        while (!merging.empty())
+        {
+            Head head = merging.popTop();
+            out.push_back(head.val);
+            if (out.size() == blockSize)
+                writeBlock(*run, out);
+            advance(head.run, merging);
+        }
+        writeBlock(*run, out);
+
+        ++io.mergePasses;
+        io.runsMerged += merged;
+        addRun(std::move(run));
+    }
+
+    std::unique_ptr<Run> newRun()
+    {
+        std::FILE *file = std::tmpfile();
+        if (!file)
+            throw std::runtime_error("ExternalPQ: cannot create a temporary file");
+        return std::unique_ptr<Run>(new Run(file));
+    }
+
+    // Append 'out' to the end of a run being written, and empty it.
+    void writeBlock(Run &run, std::vector<TYPE> &out)
+    {
+        if (out.empty())
+            return;
+        if (std::fwrite(out.data(), sizeof(TYPE), out.size(), run.file) != out.size())
+            throw std::runtime_error("ExternalPQ: write to temporary file failed");
+        run.unread += out.size();
+        ++io.writes;
+        io.bytesWritten += out.size() * sizeof(TYPE);
+        out.clear();
+    }
+
+    // Replace a run's block with the next one from its file, and ask for
+    // the block after that to be fetched in the background.
+    void readBlock(Run &run)
+    {
+        std::size_t n = std::min(blockSize, run.unread);
+        run.block.resize(n);
+        if (std::fread(run.block.data(), sizeof(TYPE), n, run.file) != n)
+            throw std::runtime_error("ExternalPQ: read from temporary file failed");
+        run.unread -= n;
+        run.offset += n * sizeof(TYPE);
+        run.next = 0;
+        ++io.reads;
+        io.bytesRead += n * sizeof(TYPE);
+
+#if defined(POSIX_FADV_WILLNEED)
+        if (run.unread)
+            posix_fadvise(fileno(run.file), static_cast<off_t>(run.offset),
+                          static_cast<off_t>(std::min(blockSize, run.unread) * sizeof(TYPE)),
+                          POSIX_FADV_WILLNEED);
+#endif
+    }
+
+    // Start reading a run that has been written, and put its first element
+    // into 'heads'.
+    void addRun(std::unique_ptr<Run> run)
+    {
+        if (run->unread == 0)
+            return;
+        if (std::fflush(run->file) != 0)
+            throw std::runtime_error("ExternalPQ: write to temporary file failed");
+        std::rewind(run->file);
+        readBlock(*run);
+
+        std::size_t slot = runs.size();
+        if (freeSlots.empty())
+            runs.push_back(std::move(run));
+        else
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            runs[slot] = std::move(run);
+        }
+        io.maxRuns = std::max(io.maxRuns, runs.size() - freeSlots.size());
+        Run &added = *runs[slot];
+        heads.push(Head{added.block[added.next++], slot});
+    }
+
+    // The head of the run in 'slot' was just taken; put its next element
+    // into 'into', or close the run if it has none left.
+    void advance(std::size_t slot, BinaryPQ<Head, HeadComp> &into)
+    {
+        Run &run = *runs[slot];
+        if (run.next == run.block.size())
+        {
+            if (run.unread == 0)
+            {
+                runs[slot].reset();
+                freeSlots.push_back(slot);
+                return;
+            }
+            readBlock(run);
+        }
+        into.push(Head{run.block[run.next++], slot});
+    }
+
+    void advance(std::size_t slot)
+    {
+        advance(slot, heads);
+    }
+}; // ExternalPQ
+
+#endif // EXTERNALPQ_H
@@ -0,0 +1,210 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef EXTREMESCAN_H
+#define EXTREMESCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+// The linear scan behind UnorderedPQ and UnorderedFastPQ: find the index of
+// the most extreme element of an array.  The generic version walks the array
+// once through the comparison functor, by pointer or by any random-access
+// iterator.  For integer and floating-point keys under std::less or
+// std::greater the answer is just the position of the max (or min), so a
+// SIMD kernel is used instead; see ExtremeLanes below.
+template <typename TYPE, typename COMP_FUNCTOR, typename Enable = void>
+struct ExtremeScan
+{
+    // Description: Return the index of the most extreme element of
+    //              data[0, n) under 'compare', the first one if several
+    //              compare equal.  Returns 0 when n is 0.
+    // Runtime: O(n)
+    template <typename Iterator>
+    static std::size_t find(Iterator data, std::size_t n, const COMP_FUNCTOR &compare)
+    {
+        std::size_t index = 0;
+        for (std::size_t i = 1; i < n; ++i)
+            if (compare(data[index], data[i]))
+                index = i;
+        return index;
+    } // find()
+}; // ExtremeScan
+
+#if defined(__GNUC__)
+
+// The SIMD kernel, for the largest (LARGEST == true) or smallest element of
+// an array of integers, floats or doubles.  It uses the GCC/Clang vector
+// extensions, so the same code compiles to SSE2 by default and to 256-bit
+// AVX2 registers when the target flags allow them.
+//
+// Each block of BLOCK elements is reduced to its extreme value by four
+// vector accumulators updated with a branch-free select, which becomes
+// packed max/min (or compare-and-blend) instructions.  Only the value is
+// tracked, and only the first block holding the overall extreme is
+// remembered, so the index is recovered at the end by rescanning that one
+// block for the first equal element.  The data is read once, plus at most
+// BLOCK elements.
+//
+// Note: For floating-point keys the array must not contain NaN; the generic
+//       scan would not give a meaningful answer for it either, since NaN
+//       breaks the strict weak ordering std::less relies on.
+template <typename TYPE, bool LARGEST>
+struct ExtremeLanes
+{
+#if defined(__AVX2__)
+    static constexpr std::size_t VECTOR_BYTES = 32;
+#else
+    static constexpr std::size_t VECTOR_BYTES = 16;
+#endif
+    typedef TYPE Vec __attribute__((vector_size(VECTOR_BYTES)));
+
+    static constexpr std::size_t LANES = VECTOR_BYTES / sizeof(TYPE);
+    static constexpr std::size_t STRIDE = 4 * LANES;
+    static constexpr std::size_t BLOCK = 256;
+
+    // The more extreme of 'a' and 'b', preferring 'a' on ties; for vectors,
+    // lane by lane.
+    template <typename T>
+    static T pick(T a, T b)
+    {
+        return LARGEST ? (a < b ? b : a) : (b < a ? b : a);
+    }
+
+    // An unaligned load of one vector's worth of keys.
+    static Vec load(const TYPE *data)
+    {
+        Vec v;
+        std::memcpy(&v, data, sizeof v);
+        return v;
+    }
+
+    static std::size_t find(const TYPE *data, std::size_t n)
+    {
+        if (n == 0)
+            return 0;
+
+        TYPE best = data[0];
+        std::size_t bestBlock = 0;
+        for (std::size_t start = 0; start < n; start += BLOCK)
+        {
+            TYPE value = blockExtreme(data + start, std::min(BLOCK, n - start));
+            if (pick(best, value) != best)
+            {
+                best = value;
+                bestBlock = start;
+            }
+        }
+
+        std::size_t i = bestBlock;
+        while (data[i] != best)
+            ++i;
+        return i;
+    } // find()
+
+    static TYPE blockExtreme(const TYPE *data, std::size_t len)
+    {
+        TYPE result = data[0];
+        std::size_t i = 1;
+        if (len >= STRIDE)
+        {
+            Vec acc0 = load(data), acc1 = load(data + LANES);
+            Vec acc2 = load(data + 2 * LANES), acc3 = load(data + 3 * LANES);
+            for (i = STRIDE; i + STRIDE <= len; i += STRIDE)
+            {
+                acc0 = pick(acc0, load(data + i));
+                acc1 = pick(acc1, load(data + i + LANES));
+                acc2 = pick(acc2, load(data + i + 2 * LANES));
+                acc3 = pick(acc3, load(data + i + 3 * LANES));
+            }
+            Vec folded = pick(pick(acc0, acc1), pick(acc2, acc3));
+            result = folded[0];
+            for (std::size_t j = 1; j < LANES; ++j)
+                result = pick(result, static_cast<TYPE>(folded[j]));
+        }
+        for (; i < len; ++i)
+            result = pick(result, data[i]);
+        return result;
+    } // blockExtreme()
+}; // ExtremeLanes
+
+// Key types the kernel handles: the ones a vector register can hold.
+template <typename TYPE>
+struct HasExtremeLanes
+    : std::integral_constant<bool, (std::is_integral<TYPE>::value && !std::is_same<TYPE, bool>::value) ||
+                                       std::is_same<TYPE, float>::value ||
+                                       std::is_same<TYPE, double>::value>
+{
+};
+
+// std::less puts the largest element on top...
+template <typename TYPE>
+struct ExtremeScan<TYPE, std::less<TYPE>, typename std::enable_if<HasExtremeLanes<TYPE>::value>::type>
+{
+    static std::size_t find(const TYPE *data, std::size_t n, const std::less<TYPE> &)
+    {
+        return ExtremeLanes<TYPE, true>::find(data, n);
+    } // find()
+}; // ExtremeScan
+
+// ...and std::greater the smallest.
+template <typename TYPE>
+struct ExtremeScan<TYPE, std::greater<TYPE>, typename std::enable_if<HasExtremeLanes<TYPE>::value>::type>
+{
+    static std::size_t find(const TYPE *data, std::size_t n, const std::greater<TYPE> &)
+    {
+        return ExtremeLanes<TYPE, false>::find(data, n);
+    } // find()
+}; // ExtremeScan
+
+#endif // __GNUC__
+
+// Description: Return the index of the most extreme element of data[0, n)
+//              under 'compare', the first one on ties, or 0 when n is 0.
+// Runtime: O(n)
+template <typename TYPE, typename COMP_FUNCTOR>
+std::size_t extremeIndex(const TYPE *data, std::size_t n, const COMP_FUNCTOR &compare)
+{
+    return ExtremeScan<TYPE, COMP_FUNCTOR>::find(data, n, compare);
+} // extremeIndex()
+
+// Description: The same for the n elements of 'data' from index 'first' on,
+//              counting the result from 'first'.
+// Runtime: O(n)
+template <typename TYPE, typename Alloc, typename COMP_FUNCTOR>
+std::size_t extremeIndex(const std::vector<TYPE, Alloc> &data, std::size_t first, std::size_t n,
+                         const COMP_FUNCTOR &compare)
+{
+    return extremeIndex(data.data() + first, n, compare);
+} // extremeIndex()
+
+// std::vector<bool> packs its elements into bits and has no data(), so it
+// takes the generic scan through its iterators.
+template <typename Alloc, typename COMP_FUNCTOR>
+std::size_t extremeIndex(const std::vector<bool, Alloc> &data, std::size_t first, std::size_t n,
+                         const COMP_FUNCTOR &compare)
+{
+    return ExtremeScan<bool, COMP_FUNCTOR>::find(data.begin() + static_cast<std::ptrdiff_t>(first), n, compare);
+} // extremeIndex()
+
+// Description: Return a const reference to data[i], for top().  The elements
+//              of a std::vector<bool> are returned by value, so for it this
+//              refers to a constant with the same value instead.
+// Runtime: O(1)
+template <typename TYPE, typename Alloc>
+const TYPE &elementAt(const std::vector<TYPE, Alloc> &data, std::size_t i)
+{
+    return data[i];
+} // elementAt()
+
+template <typename Alloc>
+const bool &elementAt(const std::vector<bool, Alloc> &data, std::size_t i)
+{
+    static const bool values[2] = {false, true};
+    return values[data[i]];
+} // elementAt()
+
+#endif // EXTREMESCAN_H
@@ -0,0 +1,254 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef HEAPCORE_H
+#define HEAPCORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// The sifts of an implicit heap with ARITY children per node, written once
+// for every queue laid out as one (BinaryPQ, IndexedBinaryPQ and
+// KeyedBinaryPQ).  The core owns no storage.  Each function takes a 'Slots'
+// object from the queue that gives it access to the queue's arrays:
+//
+//   using Entry = ...;                       an element lifted out of the heap
+//   std::size_t size() const;
+//   bool lower(std::size_t i, std::size_t j) const;      slot i below slot j
+//   bool lowerThan(std::size_t i, const Entry &e) const; slot i below e
+//   bool lowerEntry(const Entry &e, std::size_t i) const; e below slot i
+//   Entry take(std::size_t k) const;         move the element at k out
+//   void put(std::size_t k, Entry &&e) const;          move e into slot k
+//   void shift(std::size_t to, std::size_t from) const; move one slot to another
+//   void moved(std::size_t n) const;         stats hooks; see PQStats.h
+//   void sifted(std::size_t levels) const;
+//
+// put() and shift() are the only places an element changes index, so a
+// queue that keeps something else in step with its elements, such as the
+// position map of IndexedBinaryPQ, does it there.
+//
+// The sifts lift the moving element out into an Entry and shift a "hole"
+// through the heap, so each level costs a single move instead of the three
+// a swap would.
+template <std::size_t ARITY>
+struct HeapCore
+{
+    static_assert(ARITY >= 2, "a heap node needs at least two children");
+
+    static std::size_t parent(std::size_t k)
+    {
+        return (k - 1) / ARITY;
+    } // parent()
+
+    static std::size_t firstChild(std::size_t k)
+    {
+        return ARITY * k + 1;
+    } // firstChild()
+
+    // Description: Number of levels above the last of n > 0 elements.
+    // Runtime: O(log(n))
+    static std::size_t depth(std::size_t n)
+    {
+        std::size_t levels = 0;
+        for (std::size_t k = n - 1; k > 0; k = parent(k))
+            ++levels;
+        return levels;
+    } // depth()
+
+    // Description: Index of the most extreme child of k among the first n
+    //              elements; k must have at least one there.
+    // Runtime: O(ARITY)
+    template <typename Slots>
+    static std::size_t mostExtremeChild(const Slots &s, std::size_t k, std::size_t n)
+    {
+        std::size_t j = firstChild(k);
+        std::size_t last = std::min(j + ARITY, n);
+        for (std::size_t c = j + 1; c < last; ++c)
+            if (s.lower(j, c))
+                j = c;
+        return j;
+    } // mostExtremeChild()
+
+    // Description: Sift the element at k up to where it belongs.
+    // Runtime: O(log(n))
+    template <typename Slots>
+    static void fixUp(const Slots &s, std::size_t k)
+    {
+        if (k == 0)
+            return;
+        if (!s.lower(parent(k), k))
+        {
+            s.sifted(0);
+            return;
+        }
+
+        std::size_t levels = 0;
+        typename Slots::Entry val = s.take(k);
+        do
+        {
+            s.shift(k, parent(k));
+            k = parent(k);
+            ++levels;
+        } while (k > 0 && s.lowerThan(parent(k), val));
+        s.put(k, std::move(val));
+        s.moved(levels + 2);
+        s.sifted(levels);
+    } // fixUp()
+
+    // Description: Sift the element at k down to where it belongs.
+    // Runtime: O(ARITY log(n))
+    template <typename Slots>
+    static void fixDown(const Slots &s, std::size_t k)
+    {
+        std::size_t n = s.size();
+        if (firstChild(k) >= n)
+            return;
+        std::size_t j = mostExtremeChild(s, k, n);
+        if (!s.lower(k, j))
+        {
+            s.sifted(0);
+            return;
+        }
+
+        std::size_t levels = 0;
+        typename Slots::Entry val = s.take(k);
+        do
+        {
+            s.shift(k, j);
+            k = j;
+            ++levels;
+            if (firstChild(k) >= n)
+                break;
+            j = mostExtremeChild(s, k, n);
+        } while (s.lowerEntry(val, j));
+        s.put(k, std::move(val));
+        s.moved(levels + 2);
+        s.sifted(levels);
+    } // fixDown()
+
+    // Description: Sift the element at k whichever way it has to go, after
+    //              it was replaced by one that may be more or less extreme.
+    // Runtime: O(ARITY log(n))
+    template <typename Slots>
+    static void fix(const Slots &s, std::size_t k)
+    {
+        if (k > 0 && s.lower(parent(k), k))
+            fixUp(s, k);
+        else
+            fixDown(s, k);
+    } // fix()
+
+    // Description: Restore the heap invariant over all elements.  Every node
+    //              after the parent of the last element is a leaf, so sift
+    //              down the others, from the last one back to the root.
+    // Runtime: O(n)
+    template <typename Slots>
+    static void heapify(const Slots &s)
+    {
+        if (s.size() < 2)
+            return;
+
+        for (std::size_t i = parent(s.size() - 1) + 1; i-- > 0;)
+            fixDown(s, i);
+    } // heapify()
+
+    // Description: Restore the heap invariant after the elements from index
+    //              'old' on were appended, either by sifting them up one at
+    //              a time or by rebuilding the heap, whichever has the
+    //              smaller worst case: about m * depth comparisons for the
+    //              sifts against about 2(n + m) for the rebuild.
+    // Runtime: O(min(m log(n + m), n + m)) where m is size() - old.
+    template <typename Slots>
+    static void siftAppended(const Slots &s, std::size_t old)
+    {
+        std::size_t n = s.size();
+        if (n == old)
+            return;
+
+        if ((n - old) * depth(n) > 2 * n)
+            heapify(s);
+        else
+            for (std::size_t k = old; k < n; ++k)
+                fixUp(s, k);
+    } // siftAppended()
+
+    // Description: Bottom-up deletion: the element from the back almost
+    //              always ends up near a leaf, so walk the hole left at the
+    //              root of the heap formed by the first n elements all the
+    //              way down along the path of most extreme children (one
+    //              comparison among the children per level), then sift
+    //              'val' up from there.
+    // Runtime: O(ARITY log(n))
+    template <typename Slots>
+    static void dropInto(const Slots &s, typename Slots::Entry &&val, std::size_t n)
+    {
+        std::size_t k = 0;
+        std::size_t levels = 0;
+        while (firstChild(k) < n)
+        {
+            std::size_t j = mostExtremeChild(s, k, n);
+            s.shift(k, j);
+            k = j;
+            ++levels;
+        }
+        while (k > 0 && s.lowerThan(parent(k), val))
+        {
+            s.shift(k, parent(k));
+            k = parent(k);
+            ++levels;
+        }
+        s.put(k, std::move(val));
+        s.moved(levels + 1);
+        s.sifted(levels);
+    } // dropInto()
+
+    // Description: Heapsort in place, into ascending order by the queue's
+    //              comparison: swap the root with the last element of the
+    //              shrinking heap, and sift from the root with dropInto().
+    // Runtime: O(n log(n))
+    template <typename Slots>
+    static void sortInPlace(const Slots &s)
+    {
+        for (std::size_t n = s.size(); n > 1; --n)
+        {
+            typename Slots::Entry val = s.take(n - 1);
+            s.shift(n - 1, 0);
+            s.moved(2);
+            dropInto(s, std::move(val), n - 1);
+        }
+    } // sortInPlace()
+
+    // Description: Sift down every position in 'dirty' and each of its
+    //              ancestors, deepest first, so each sift starts above
+    //              subheaps that are already valid; or rebuild the whole heap
+    //              if those sifts would cost more than about n / 2 steps.
+    // Runtime: O(k log^2(n)) where k is dirty.size(), or O(n) for a rebuild.
+    template <typename Slots>
+    static void repair(const Slots &s, std::vector<std::size_t> &dirty)
+    {
+        if (dirty.empty())
+            return;
+
+        if (dirty.size() * depth(s.size()) > s.size() / 2)
+        {
+            heapify(s);
+            return;
+        }
+
+        std::size_t count = dirty.size();
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = dirty[i]; k > 0;)
+            {
+                k = parent(k);
+                dirty.push_back(k);
+            }
+        std::sort(dirty.begin(), dirty.end(), std::greater<std::size_t>());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        for (std::size_t k : dirty)
+            fixDown(s, k);
+    } // repair()
+}; // HeapCore
+
+#endif // HEAPCORE_H
@@ -0,0 +1,434 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef INDEXEDBINARYPQ_H
+#define INDEXEDBINARYPQ_H
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include "Eecs281PQ.h"
+#include "HeapCore.h"
+#include "PQStats.h"
+
+// A heap, laid out like BinaryPQ with ARITY children per node, that hands
+// out a stable handle for every element it holds.  Alongside the heap array
+// it keeps a position map from each handle to the element's current index,
+// so an element can be reprioritized or removed in O(log(n)) without
+// rebuilding the heap.  The sifts are HeapCore's, as in BinaryPQ; the map
+// is kept in step by the two places they move an element, Slots::put() and
+// Slots::shift().
+// STATS is the stats policy; see PQStats.h.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t ARITY = 2,
+          typename STATS = NoStats>
+class IndexedBinaryPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS>
+{
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Core = HeapCore<ARITY>;
+
+    static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+public:
+    // An opaque reference to one element of the heap.  It stays valid until
+    // that element is popped or erased; its slot may then be reused.
+    class Handle
+    {
+    public:
+        Handle() : id{NONE} {}
+
+        bool operator==(const Handle &other) const { return id == other.id; }
+        bool operator!=(const Handle &other) const { return id != other.id; }
+
+        friend IndexedBinaryPQ;
+
+    private:
+        explicit Handle(std::size_t i) : id{i} {}
+
+        std::size_t id;
+    }; // Handle
+
+    // Description: Construct an empty heap with an optional comparison functor.
+    // Runtime: O(1)
+    explicit IndexedBinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass{comp}, freeIds{NONE}
+    {
+    } // IndexedBinaryPQ
+
+    // Description: Construct a heap out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template <typename InputIterator>
+    IndexedBinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass{comp}, data{start, end}, freeIds{NONE}
+    {
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(size());
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            heapToId.push_back(i);
+            idToPos.push_back(i);
+        }
+        Core::heapify(slots());
+    } // IndexedBinaryPQ
+
+    // Description: Destructor doesn't need any code, the vectors will be
+    //              destroyed automatically.
+    virtual ~IndexedBinaryPQ()
+    {
+    } // ~IndexedBinaryPQ()
+
+    // Description: Assumes that all elements inside the heap are out of order and
+    //              'rebuilds' the heap by fixing the heap invariant.  Handles
+    //              stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities()
+    {
+        this->counters().begin(PQOp::Update);
+        Core::heapify(slots());
+    } // updatePriorities()
+
+    // Description: Restore the heap invariant after the priorities of the
+    //              elements referred to by 'changed' have changed in place, in
+    //              either direction.  As in BinaryPQ, only those elements and
+    //              their ancestors are sifted down, deepest first, falling
+    //              back to updatePriorities() when that would touch a large
+    //              part of the heap.  Handles stay valid.
+    // Runtime: O(k log^2(n)) where k is changed.size(), or O(n) for a rebuild.
+    void updatePriorities(const std::vector<Handle> &changed)
+    {
+        this->counters().begin(PQOp::Update);
+        std::vector<std::size_t> dirty;
+        dirty.reserve(changed.size());
+        for (Handle handle : changed)
+            dirty.push_back(idToPos[handle.id]);
+        Core::repair(slots(), dirty);
+    } // updatePriorities()
+
+    // Description: Add a new element to the heap.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val)
+    {
+        addElt(val);
+    } // push()
+
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: O(log(n))
+    virtual void push(TYPE &&val)
+    {
+        addElt(std::move(val));
+    } // push()
+
+    // Description: Add a new element to the heap and return its handle.
+    // Runtime: O(log(n))
+    Handle addElt(const TYPE &val)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(val);
+        return attachLast();
+    } // addElt()
+
+    // Description: Add a new element to the heap, moving from 'val', and
+    //              return its handle.
+    // Runtime: O(log(n))
+    Handle addElt(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(std::move(val));
+        return attachLast();
+    } // addElt()
+
+    // Description: Add every element of the range [first, last) to the heap,
+    //              choosing between per-element sifts and a full rebuild as
+    //              BinaryPQ::pushRange() does.  The new elements get handles
+    //              like any others, but they are not returned; use addElt()
+    //              when the caller needs them.
+    // Runtime: O(min(m log(n + m), n + m)) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::size_t old = size();
+        for (; first != last; ++first)
+        {
+            data.push_back(*first);
+            std::size_t id = takeId();
+            heapToId.push_back(id);
+            idToPos[id] = size() - 1;
+        }
+        this->counters().moved(size() - old);
+        Core::siftAppended(slots(), old);
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this heap, leaving
+    //              'other' empty.  The elements are added as by pushRange()
+    //              and get new handles here; handles obtained from 'other'
+    //              are invalidated, and this heap's own handles stay valid.
+    // Runtime: O(min(m log(n + m), n + m)) where m is other.size().
+    void merge(IndexedBinaryPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        pushRange(std::make_move_iterator(other.data.begin()),
+                  std::make_move_iterator(other.data.end()));
+        other.data.clear();
+        other.heapToId.clear();
+        other.idToPos.clear();
+        other.freeIds = NONE;
+    } // merge()
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the heap.  Its handle becomes invalid.
+    // Runtime: O(log(n))
+    virtual void pop()
+    {
+        this->counters().begin(PQOp::Pop);
+        removeAt(0);
+    } // pop()
+
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: O(log(n))
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(data[0]);
+        removeAt(0);
+        return val;
+    } // popTop()
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  Returns the output iterator past the last element
+    //              written.  Every handle is invalidated.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        this->counters().moved(size());
+        out = std::move(data.begin(), data.end(), out);
+        clearHandles();
+        return out;
+    } // drainSorted()
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them.  The heap is sorted in place
+    //              and its storage handed over.  Every handle is invalidated.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        clearHandles();
+        return sorted;
+    } // extractSorted()
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const
+    {
+        this->counters().begin(PQOp::Top);
+        return data[0];
+    } // top()
+
+    // Description: Return the handle of the most extreme element.
+    // Runtime: O(1)
+    Handle topHandle() const
+    {
+        return Handle{heapToId[0]};
+    } // topHandle()
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const
+    {
+        return data.size();
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const
+    {
+        return data.empty();
+    } // empty()
+
+    // Description: Return the element referred to by 'handle'.
+    // Runtime: O(1)
+    const TYPE &getElt(Handle handle) const
+    {
+        return data[idToPos[handle.id]];
+    } // getElt()
+
+    // Description: Replace the element referred to by 'handle' with
+    //              'new_value', which may be more or less extreme than the
+    //              old one, and restore the heap invariant.
+    // Runtime: O(log(n))
+    void update(Handle handle, const TYPE &new_value)
+    {
+        this->counters().begin(PQOp::Update);
+        this->counters().moved();
+        std::size_t k = idToPos[handle.id];
+        data[k] = new_value;
+        Core::fix(slots(), k);
+    } // update()
+
+    // Description: Remove the element referred to by 'handle' from the heap.
+    //              The handle becomes invalid.
+    // Runtime: O(log(n))
+    void erase(Handle handle)
+    {
+        this->counters().begin(PQOp::Pop);
+        removeAt(idToPos[handle.id]);
+    } // erase()
+
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
+private:
+    // The heap itself, and for each heap index the id of the handle that
+    // refers to it.
+    std::vector<TYPE> data;
+    std::vector<std::size_t> heapToId;
+
+    // For each live handle id, the heap index of its element.  Ids that are
+    // not in use form a free list threaded through this same vector,
+    // starting at freeIds.
+    std::vector<std::size_t> idToPos;
+    std::size_t freeIds;
+
+
+    // this->compare, reported to the stats policy.
+    bool lower(const TYPE &a, const TYPE &b) const
+    {
+        this->counters().compared();
+        return this->compare(a, b);
+    }
+
+    // An element lifted out of the heap, with the id of its handle.
+    struct Entry
+    {
+        TYPE val;
+        std::size_t id;
+    }; // Entry
+
+    // HeapCore's view of the heap.  Every element it moves takes its handle
+    // id along, and the id's entry in the position map follows.
+    struct Slots
+    {
+        using Entry = IndexedBinaryPQ::Entry;
+
+        IndexedBinaryPQ &pq;
+
+        std::size_t size() const { return pq.data.size(); }
+        bool lower(std::size_t i, std::size_t j) const { return pq.lower(pq.data[i], pq.data[j]); }
+        bool lowerThan(std::size_t i, const Entry &e) const { return pq.lower(pq.data[i], e.val); }
+        bool lowerEntry(const Entry &e, std::size_t i) const { return pq.lower(e.val, pq.data[i]); }
+        Entry take(std::size_t k) const { return Entry{std::move(pq.data[k]), pq.heapToId[k]}; }
+
+        void put(std::size_t k, Entry &&e) const
+        {
+            pq.data[k] = std::move(e.val);
+            pq.heapToId[k] = e.id;
+            pq.idToPos[e.id] = k;
+        }
+
+        void shift(std::size_t to, std::size_t from) const
+        {
+            pq.data[to] = std::move(pq.data[from]);
+            pq.heapToId[to] = pq.heapToId[from];
+            pq.idToPos[pq.heapToId[to]] = to;
+        }
+
+        void moved(std::size_t n) const { pq.counters().moved(n); }
+        void sifted(std::size_t levels) const { pq.counters().sifted(levels); }
+    }; // Slots
+
+    Slots slots()
+    {
+        return Slots{*this};
+    } // slots()
+
+    // Empty the heap and forget every handle id.
+    void clearHandles()
+    {
+        data.clear();
+        heapToId.clear();
+        idToPos.clear();
+        freeIds = NONE;
+    } // clearHandles()
+
+    // Take an unused handle id, recycling one if possible.
+    std::size_t takeId()
+    {
+        std::size_t id = freeIds;
+        if (id == NONE)
+        {
+            id = idToPos.size();
+            idToPos.push_back(0);
+        }
+        else
+            freeIds = idToPos[id];
+        return id;
+    } // takeId()
+
+    // Give the element just appended to data a handle and sift it up.
+    Handle attachLast()
+    {
+        std::size_t id = takeId();
+        heapToId.push_back(id);
+        idToPos[id] = size() - 1;
+        Core::fixUp(slots(), size() - 1);
+        return Handle{id};
+    } // attachLast()
+
+    // Remove the element at heap index k and recycle its handle id.  The
+    // back element takes its place: at the root it is dropped in bottom-up,
+    // as by BinaryPQ::pop(), and elsewhere it is sifted whichever way it
+    // has to go.
+    void removeAt(std::size_t k)
+    {
+        std::size_t id = heapToId[k];
+        std::size_t last = size() - 1;
+        Entry back{std::move(data[last]), heapToId[last]};
+        data.pop_back();
+        heapToId.pop_back();
+        this->counters().moved();
+        idToPos[id] = freeIds;
+        freeIds = id;
+
+        if (k == last)
+            return;
+        if (k == 0)
+            Core::dropInto(slots(), std::move(back), size());
+        else
+        {
+            Slots s = slots();
+            s.put(k, std::move(back));
+            Core::fix(s, k);
+        }
+    } // removeAt()
+}; // IndexedBinaryPQ
+
+#endif // INDEXEDBINARYPQ_H
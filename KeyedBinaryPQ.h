@@ -0,0 +1,384 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef KEYEDBINARYPQ_H
+#define KEYEDBINARYPQ_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Eecs281PQ.h"
+#include "HeapCore.h"
+#include "PQStats.h"
+
+// The type of the key KEY_OF extracts from a TYPE.
+template <typename TYPE, typename KEY_OF>
+using ExtractedKey =
+    typename std::decay<decltype(std::declval<const KEY_OF &>()(std::declval<const TYPE &>()))>::type;
+
+// The comparison functor a KeyedBinaryPQ hands to Eecs281PQ: one element is
+// lower priority than another when 'keyCompare' says its key is.
+template <typename TYPE, typename KEY_OF, typename KEY_COMP>
+struct KeyedCompare
+{
+    KEY_OF keyOf;
+    KEY_COMP keyCompare;
+
+    bool operator()(const TYPE &a, const TYPE &b) const
+    {
+        return keyCompare(keyOf(a), keyOf(b));
+    }
+}; // KeyedCompare
+
+// A d-ary heap, like BinaryPQ, for elements whose priority is a small key
+// KEY_OF extracts from them: a pointer and the value it points to, or a
+// large struct and one of its fields.  The keys are cached in an array of
+// their own, parallel to the elements, so the sifts compare only keys that
+// lie next to each other instead of following each element to wherever its
+// key lives.  KEY_OF is called once for each element pushed, and once for
+// each element by updatePriorities(), never while sifting.
+//
+// Because the keys are cached, a change to an element's key is not seen
+// until updatePriorities() is called, which refreshes every cached key in
+// one pass and sifts only the elements whose key changed.
+//
+// The sifts are HeapCore's, as in BinaryPQ; this queue only tells them to
+// compare the cached keys and to move each key along with its element.
+template <typename TYPE, typename KEY_OF,
+          typename KEY_COMP = std::less<ExtractedKey<TYPE, KEY_OF>>, std::size_t ARITY = 2,
+          typename STATS = NoStats>
+class KeyedBinaryPQ final : public Eecs281PQ<TYPE, KeyedCompare<TYPE, KEY_OF, KEY_COMP>>,
+                            private PQStatsHolder<STATS>
+{
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, KeyedCompare<TYPE, KEY_OF, KEY_COMP>>;
+
+    using Core = HeapCore<ARITY>;
+
+    using Key = ExtractedKey<TYPE, KEY_OF>;
+
+public:
+    // Description: Construct an empty heap with an optional key extractor
+    //              and key comparison functor.
+    // Runtime: O(1)
+    explicit KeyedBinaryPQ(KEY_OF keyOf = KEY_OF(), KEY_COMP comp = KEY_COMP())
+        : BaseClass{KeyedCompare<TYPE, KEY_OF, KEY_COMP>{keyOf, comp}}
+    {
+    } // KeyedBinaryPQ
+
+    // Description: Construct a heap out of an iterator range with an optional
+    //              key extractor and key comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template <typename InputIterator>
+    KeyedBinaryPQ(InputIterator start, InputIterator end, KEY_OF keyOf = KEY_OF(),
+                  KEY_COMP comp = KEY_COMP())
+        : BaseClass{KeyedCompare<TYPE, KEY_OF, KEY_COMP>{keyOf, comp}}, data{start, end}
+    {
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(size());
+        cacheKeys(0);
+        Core::heapify(slots());
+    } // KeyedBinaryPQ
+
+    // Description: Destructor doesn't need any code, the vectors will be
+    //              destroyed automatically.
+    virtual ~KeyedBinaryPQ()
+    {
+    } // ~KeyedBinaryPQ()
+
+    // Description: Extract every element's key again, in one pass over the
+    //              elements, and restore the heap invariant for those whose
+    //              key changed.  They are sifted down with their ancestors,
+    //              deepest first, as by BinaryPQ::updatePriorities(changed),
+    //              or the heap is rebuilt when that would touch a large part
+    //              of it.
+    // Runtime: O(n) calls to KEY_OF, plus O(k log^2(n)) comparisons where k
+    //          is the number of changed keys, or O(n) for a rebuild.
+    virtual void updatePriorities()
+    {
+        this->counters().begin(PQOp::Update);
+        std::vector<std::size_t> dirty;
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            Key key = keyOf(data[i]);
+            if (lower(key, keys[i]) || lower(keys[i], key))
+            {
+                keys[i] = std::move(key);
+                dirty.push_back(i);
+            }
+        }
+        Core::repair(slots(), dirty);
+    } // updatePriorities()
+
+    // Description: Add a new element to the heap.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(val);
+        keys.push_back(keyOf(data.back()));
+        Core::fixUp(slots(), size() - 1);
+    } // push()
+
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: O(log(n))
+    virtual void push(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(std::move(val));
+        keys.push_back(keyOf(data.back()));
+        Core::fixUp(slots(), size() - 1);
+    } // push()
+
+    // Description: Construct a new element in place at the back of the heap
+    //              from 'args', then fix the heap invariant.
+    // Runtime: O(log(n))
+    template <typename... Args>
+    void emplace(Args &&... args)
+    {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.emplace_back(std::forward<Args>(args)...);
+        keys.push_back(keyOf(data.back()));
+        Core::fixUp(slots(), size() - 1);
+    } // emplace()
+
+    // Description: Add every element of the range [first, last) to the heap,
+    //              sifting the new elements up one at a time or rebuilding
+    //              the heap, whichever has the smaller worst case, as in
+    //              BinaryPQ::pushRange().
+    // Runtime: O(min(m log(n + m), n + m)) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::size_t old = size();
+        data.insert(data.end(), first, last);
+        this->counters().moved(size() - old);
+        cacheKeys(old);
+        Core::siftAppended(slots(), old);
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this heap with its
+    //              cached key, leaving 'other' empty.  If this heap is empty
+    //              the two simply trade storage; otherwise the elements are
+    //              added as by pushRange(), without extracting their keys
+    //              again.
+    // Runtime: O(min(m log(n + m), n + m)) where m is other.size().
+    void merge(KeyedBinaryPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        if (empty())
+        {
+            data.swap(other.data);
+            keys.swap(other.keys);
+        }
+        else
+        {
+            std::size_t old = size();
+            data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                        std::make_move_iterator(other.data.end()));
+            keys.insert(keys.end(), std::make_move_iterator(other.keys.begin()),
+                        std::make_move_iterator(other.keys.end()));
+            this->counters().moved(size() - old);
+            Core::siftAppended(slots(), old);
+        }
+        other.data.clear();
+        other.keys.clear();
+    } // merge()
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the heap.
+    // Runtime: O(log(n))
+    virtual void pop()
+    {
+        this->counters().begin(PQOp::Pop);
+        removeTop();
+    } // pop()
+
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: O(log(n))
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(data[0]);
+        removeTop();
+        return val;
+    } // popTop()
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last, by heapsorting it in place.  Returns the output
+    //              iterator past the last element written.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        this->counters().moved(size());
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        keys.clear();
+        return out;
+    } // drainSorted()
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them, handing over its own storage.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        Core::sortInPlace(slots());
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        keys.clear();
+        return sorted;
+    } // extractSorted()
+
+    // Description: Make room for 'n' elements and their keys, so the heap
+    //              does not allocate again until it holds more than that.
+    // Runtime: O(n) if storage is reallocated, otherwise O(1)
+    void reserve(std::size_t n)
+    {
+        data.reserve(n);
+        keys.reserve(n);
+    } // reserve()
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const
+    {
+        this->counters().begin(PQOp::Top);
+        return data[0];
+    } // top()
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const
+    {
+        return data.size();
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const
+    {
+        return data.empty();
+    } // empty()
+
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.  A move counts an element and its
+    //              key as one.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
+private:
+    // The heap, in the same layout as BinaryPQ::data, and keys[i], the key
+    // of data[i] when it was last extracted.  Every sift moves an element
+    // and its key together.
+    std::vector<TYPE> data;
+    std::vector<Key> keys;
+
+
+    Key keyOf(const TYPE &val) const
+    {
+        return this->compare.keyOf(val);
+    }
+
+    // this->compare.keyCompare, reported to the stats policy.
+    bool lower(const Key &a, const Key &b) const
+    {
+        this->counters().compared();
+        return this->compare.keyCompare(a, b);
+    }
+
+    // Extract the keys of data[from] onwards, which have none yet.
+    void cacheKeys(std::size_t from)
+    {
+        keys.reserve(size());
+        for (std::size_t i = from; i < size(); ++i)
+            keys.push_back(keyOf(data[i]));
+    }
+
+    // An element lifted out of the heap, with its key.
+    struct Entry
+    {
+        Key key;
+        TYPE val;
+    }; // Entry
+
+    // HeapCore's view of the heap: it compares keys[] and moves each key
+    // along with its element.
+    struct Slots
+    {
+        using Entry = KeyedBinaryPQ::Entry;
+
+        KeyedBinaryPQ &pq;
+
+        std::size_t size() const { return pq.data.size(); }
+        bool lower(std::size_t i, std::size_t j) const { return pq.lower(pq.keys[i], pq.keys[j]); }
+        bool lowerThan(std::size_t i, const Entry &e) const { return pq.lower(pq.keys[i], e.key); }
+        bool lowerEntry(const Entry &e, std::size_t i) const { return pq.lower(e.key, pq.keys[i]); }
+
+        Entry take(std::size_t k) const
+        {
+            return Entry{std::move(pq.keys[k]), std::move(pq.data[k])};
+        }
+
+        void put(std::size_t k, Entry &&e) const
+        {
+            pq.keys[k] = std::move(e.key);
+            pq.data[k] = std::move(e.val);
+        }
+
+        void shift(std::size_t to, std::size_t from) const
+        {
+            pq.keys[to] = std::move(pq.keys[from]);
+            pq.data[to] = std::move(pq.data[from]);
+        }
+
+        void moved(std::size_t n) const { pq.counters().moved(n); }
+        void sifted(std::size_t levels) const { pq.counters().sifted(levels); }
+    }; // Slots
+
+    Slots slots()
+    {
+        return Slots{*this};
+    }
+
+    // Remove the root by moving the back element (and its key) into its
+    // place, with HeapCore::dropInto().
+    void removeTop()
+    {
+        Entry back{std::move(keys.back()), std::move(data.back())};
+        keys.pop_back();
+        data.pop_back();
+        this->counters().moved();
+        if (!empty())
+            Core::dropInto(slots(), std::move(back), size());
+    }
+}; // KeyedBinaryPQ
+
+#endif // KEYEDBINARYPQ_H
@@ -0,0 +1,193 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef MULTIQUEUE_H
+#define MULTIQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "BinaryPQ.h"
+
+// A relaxed priority queue that many threads can use at once (the MultiQueue
+// of Rihani, Sanders and Dementiev).  It keeps several ordinary BinaryPQ
+// shards, each behind its own mutex.  push() adds to a random shard.
+// tryPop() picks two random shards and removes the better of their two
+// tops, so it does not always return the most extreme element overall, but
+// one whose expected rank is O(number of shards).  Both take their locks
+// with try_lock() and simply pick other shards when one is busy, so threads
+// do not wait on each other while the queue is busy.
+//
+// Since there is no stable top() under concurrent pops, this is not an
+// Eecs281PQ: pop and read the element in one call with tryPop().
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class MultiQueue
+{
+public:
+    // Description: Construct an empty queue for 'threads' threads, with
+    //              'perThread' shards for each of them.
+    // Runtime: O(threads * perThread)
+    explicit MultiQueue(std::size_t threads, std::size_t perThread = 2, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : compare{comp}, count{0}
+    {
+        std::size_t n = std::max<std::size_t>(1, threads * perThread);
+        for (std::size_t i = 0; i < n; ++i)
+            shards.emplace_back(comp);
+    } // MultiQueue()
+
+    MultiQueue(const MultiQueue &) = delete;
+    MultiQueue &operator=(const MultiQueue &) = delete;
+
+    // Description: Add a new element to a random shard.
+    // Runtime: O(log(n / shards)), plus retries while shards are busy.
+    void push(const TYPE &val)
+    {
+        Shard &shard = lockAny();
+        shard.heap.push(val);
+        count.fetch_add(1, std::memory_order_relaxed);
+        shard.lock.unlock();
+    } // push()
+
+    // Description: Add a new element to a random shard, moving from 'val'.
+    // Runtime: O(log(n / shards)), plus retries while shards are busy.
+    void push(TYPE &&val)
+    {
+        Shard &shard = lockAny();
+        shard.heap.push(std::move(val));
+        count.fetch_add(1, std::memory_order_relaxed);
+        shard.lock.unlock();
+    } // push()
+
+    // Description: Remove the more extreme of the tops of two random shards
+    //              and move it into 'out'.  Returns false, leaving 'out'
+    //              alone, if the queue was found empty.  After a number of
+    //              failed attempts (busy or empty shards) it stops sampling
+    //              and checks every shard in turn, waiting for each lock.
+    // Runtime: O(log(n / shards)), plus retries while shards are busy.
+    bool tryPop(TYPE &out)
+    {
+        for (std::size_t attempt = 0; attempt < 4 * shards.size(); ++attempt)
+        {
+            if (count.load(std::memory_order_relaxed) == 0)
+                return false;
+
+            Shard &a = shards[randomIndex(shards.size())];
+            Shard &b = shards[randomIndex(shards.size())];
+            if (!a.lock.try_lock())
+                continue;
+            if (&b != &a && !b.lock.try_lock())
+            {
+                a.lock.unlock();
+                continue;
+            }
+
+            Shard *best = &a;
+            if (&b != &a)
+            {
+                if (a.heap.empty() || (!b.heap.empty() && compare(a.heap.top(), b.heap.top())))
+                    best = &b;
+                (best == &a ? b : a).lock.unlock();
+            }
+            if (popFrom(*best, out))
+                return true;
+        }
+
+        for (Shard &shard : shards)
+        {
+            shard.lock.lock();
+            if (popFrom(shard, out))
+                return true;
+        }
+        return false;
+    } // tryPop()
+
+    // Description: Get the number of elements in the queue.  With other
+    //              threads pushing and popping, this is only a snapshot.
+    // Runtime: O(1)
+    std::size_t size() const
+    {
+        return count.load(std::memory_order_relaxed);
+    } // size()
+
+    // Description: Return true if the queue is empty, with the same caveat as
+    //              size().
+    // Runtime: O(1)
+    bool empty() const
+    {
+        return size() == 0;
+    } // empty()
+
+    // Description: Get the number of shards.
+    // Runtime: O(1)
+    std::size_t shardCount() const
+    {
+        return shards.size();
+    } // shardCount()
+
+private:
+    // One heap and its lock, kept on its own cache lines so threads working
+    // on neighboring shards do not slow each other down.
+    struct alignas(64) Shard
+    {
+        explicit Shard(const COMP_FUNCTOR &comp) : heap{comp} {}
+
+        std::mutex lock;
+        BinaryPQ<TYPE, COMP_FUNCTOR> heap;
+    }; // Shard
+
+    // A deque, because a Shard cannot be moved once its mutex exists.
+    std::deque<Shard> shards;
+    COMP_FUNCTOR compare;
+    std::atomic<std::size_t> count;
+
+    // Lock a random shard, trying others while the chosen ones are busy,
+    // and return it.
+    Shard &lockAny()
+    {
+        for (std::size_t attempt = 0; attempt < 4 * shards.size(); ++attempt)
+        {
+            Shard &shard = shards[randomIndex(shards.size())];
+            if (shard.lock.try_lock())
+                return shard;
+        }
+        Shard &shard = shards[randomIndex(shards.size())];
+        shard.lock.lock();
+        return shard;
+    } // lockAny()
+
+    // Pop the top of a locked shard into 'out' and unlock it; returns false
+    // if the shard was empty.
+    bool popFrom(Shard &shard, TYPE &out)
+    {
+        bool found = !shard.heap.empty();
+        if (found)
+        {
+            out = shard.heap.popTop();
+            count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        shard.lock.unlock();
+        return found;
+    } // popFrom()
+
+    // A uniform index below n from a per-thread xorshift generator; each
+    // thread starts from a different seed.
+    static std::size_t randomIndex(std::size_t n)
+    {
+        static std::atomic<std::uint64_t> seeds{0};
+        thread_local std::uint64_t state =
+            (std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+             (seeds.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull)) | 1;
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::size_t>((state >> 32) * n >> 32);
+    } // randomIndex()
+}; // MultiQueue
+
+#endif // MULTIQUEUE_H
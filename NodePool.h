@@ -0,0 +1,195 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A slab allocator for the nodes of a node-based priority queue.
+// Nodes are carved out of slabs that grow geometrically, and destroyed
+// nodes are threaded onto a free list so later construct() calls can reuse
+// them without going back to the system allocator.  A node never moves
+// while it is alive, so pointers returned by construct() stay valid until
+// the matching destroy().  All slabs are released at once when the pool is
+// destroyed.
+template <typename NODE>
+class NodePool
+{
+public:
+    // Description: Construct an empty pool; no memory is allocated until the
+    //              first node is constructed.
+    // Runtime: O(1)
+    NodePool() : freeList{nullptr}, freeTail{nullptr}, next{nullptr}, last{nullptr},
+                 nextSlab{FIRST_SLAB}
+    {
+    } // NodePool()
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    // Description: Release every slab in bulk.  Nodes that are still alive
+    //              are NOT destroyed; the owner must destroy them first if
+    //              NODE has a non-trivial destructor.
+    // Runtime: O(number of slabs)
+    ~NodePool()
+    {
+        for (Slot *slab : slabs)
+            ::operator delete(slab);
+    } // ~NodePool()
+
+    // Description: Construct a NODE from 'args' in pooled storage.
+    // Runtime: Amortized O(1)
+    template <typename... Args>
+    NODE *construct(Args &&... args)
+    {
+        Slot *slot = allocate();
+        try
+        {
+            return ::new (static_cast<void *>(slot->storage)) NODE(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            release(slot);
+            throw;
+        }
+    } // construct()
+
+    // Description: Let the next 'n' nodes be constructed with one call to
+    //              the system allocator, by starting a slab of exactly 'n'
+    //              slots if the current one has fewer left and 'n' is more
+    //              than the next slab would hold anyway.  The rest of the
+    //              current slab then stays unused until the pool is
+    //              destroyed, and slots on the free list are not counted, so
+    //              this is meant for filling a new pool.
+    // Runtime: O(1)
+    void reserve(std::size_t n)
+    {
+        if (static_cast<std::size_t>(last - next) >= n || n <= nextSlab)
+            return;
+        addSlab(n);
+        nextSlab = std::min(std::max(nextSlab, n), MAX_SLAB);
+    } // reserve()
+
+    // Description: Destroy a NODE created by construct() and recycle its
+    //              storage through the free list.
+    // Runtime: O(1)
+    void destroy(NODE *node)
+    {
+        node->~NODE();
+        release(reinterpret_cast<Slot *>(node));
+    } // destroy()
+
+    // Description: Exchange the contents of two pools.  Nodes keep their
+    //              addresses; only ownership of the slabs changes hands.
+    // Runtime: O(1)
+    void swap(NodePool &other) noexcept
+    {
+        std::swap(freeList, other.freeList);
+        std::swap(freeTail, other.freeTail);
+        std::swap(next, other.next);
+        std::swap(last, other.last);
+        std::swap(nextSlab, other.nextSlab);
+        slabs.swap(other.slabs);
+    } // swap()
+
+    // Description: Take over every slab of 'other', including the nodes
+    //              still alive in them, which keep their addresses.  The two
+    //              free lists are spliced together, and whichever pool has
+    //              more never-used slots left in its current slab keeps
+    //              carving from it; the rest of the other one stays unused
+    //              until this pool is destroyed.  'other' is left empty.
+    // Runtime: O(number of slabs in 'other')
+    void absorb(NodePool &other)
+    {
+        if (&other == this)
+            return;
+
+        if (other.freeList)
+        {
+            other.freeTail->link = freeList;
+            if (!freeList)
+                freeTail = other.freeTail;
+            freeList = other.freeList;
+        }
+        if (other.last - other.next > last - next)
+        {
+            next = other.next;
+            last = other.last;
+        }
+        nextSlab = std::max(nextSlab, other.nextSlab);
+        slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+
+        other.slabs.clear();
+        other.freeList = other.freeTail = other.next = other.last = nullptr;
+        other.nextSlab = FIRST_SLAB;
+    } // absorb()
+
+private:
+    // Storage for one node, or a link in the free list once it is released.
+    union Slot
+    {
+        Slot *link;
+        alignas(NODE) unsigned char storage[sizeof(NODE)];
+    }; // Slot
+
+    static_assert(alignof(Slot) <= alignof(std::max_align_t),
+                  "NodePool relies on ::operator new alignment");
+
+    // Smallest and largest slab sizes, in nodes.
+    static constexpr std::size_t FIRST_SLAB = 32;
+    static constexpr std::size_t MAX_SLAB = std::size_t{1} << 16;
+
+    Slot *freeList;           // most recently released slot, or nullptr
+    Slot *freeTail;           // least recently released slot, or nullptr
+    Slot *next;               // next never-used slot in the current slab
+    Slot *last;               // one past the end of the current slab
+    std::size_t nextSlab;     // number of slots in the next slab to allocate
+    std::vector<Slot *> slabs;
+
+    Slot *allocate()
+    {
+        if (freeList)
+        {
+            Slot *slot = freeList;
+            freeList = slot->link;
+            if (!freeList)
+                freeTail = nullptr;
+            return slot;
+        } // if
+
+        if (next == last)
+            grow();
+        return next++;
+    } // allocate()
+
+    void release(Slot *slot)
+    {
+        slot->link = freeList;
+        if (!freeList)
+            freeTail = slot;
+        freeList = slot;
+    } // release()
+
+    // Add a new slab twice the size of the previous one, up to MAX_SLAB.
+    void grow()
+    {
+        addSlab(nextSlab);
+        nextSlab = std::min(nextSlab * 2, MAX_SLAB);
+    } // grow()
+
+    // Allocate a slab of 'size' slots and carve from it from now on.
+    void addSlab(std::size_t size)
+    {
+        slabs.reserve(slabs.size() + 1);
+        Slot *slab = static_cast<Slot *>(::operator new(size * sizeof(Slot)));
+        slabs.push_back(slab);
+        next = slab;
+        last = slab + size;
+    } // addSlab()
+}; // NodePool
+
+#endif // NODEPOOL_H
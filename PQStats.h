@@ -0,0 +1,321 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef PQSTATS_H
+#define PQSTATS_H
+
+#include <cstddef>
+
+// Stats policies for the priority queues.  Every queue takes one as its last
+// template parameter and calls its hooks as it works: begin() at the start
+// of each public operation, compared() for every call to 'compare', moved()
+// for every element it moves or copies itself, and so on.  The default,
+// NoStats, has empty inline hooks, so an uninstrumented queue compiles to
+// the same code as before, and holds it through PQStatsHolder, so it takes
+// no space either.  CountingStats records everything, and is read through
+// the queue's stats() accessor:
+//
+//     BinaryPQ<int, std::less<int>, 2, CountingStats> pq;
+//     ...
+//     pq.stats()[PQOp::Pop].compares / pq.stats()[PQOp::Pop].calls
+//
+// Moves made inside the standard algorithms a queue calls (std::sort,
+// vector reallocation, ...) cannot be seen and are not counted.
+//
+// The hooks are const, since a queue's const members such as top() report
+// to them too; a policy that records keeps its counts in mutable members.
+
+// The operations costs are charged to.  Pop also covers the erase() of
+// PairingPQ, RankPairingPQ and IndexedBinaryPQ and BinaryPQ::replaceTop(),
+// Update IndexedBinaryPQ::update(), and Bulk the range constructors,
+// pushRange(), merge() and drainSorted().
+enum class PQOp
+{
+    Push,
+    Pop,
+    Top,
+    Update,
+    Bulk
+};
+
+// The no-op policy.
+struct NoStats
+{
+    void begin(PQOp) const {}
+    void compared() const {}
+    void moved(std::size_t = 1) const {}
+    void allocated() const {}
+    void sifted(std::size_t) const {}
+    void melded(std::size_t) const {}
+    void scanned(std::size_t) const {}
+    void reset() {}
+}; // NoStats
+
+// A histogram of non-negative sizes in power-of-two buckets: bucket 0 counts
+// the zeros, and bucket b > 0 the values v with 2^(b-1) <= v < 2^b.  The
+// exact sum and maximum are kept as well.
+class PQHistogram
+{
+public:
+    static constexpr std::size_t BUCKETS = 65;
+
+    // Description: Construct an empty histogram.
+    // Runtime: O(1)
+    PQHistogram()
+    {
+        reset();
+    } // PQHistogram()
+
+    // Description: Add one value.
+    // Runtime: O(1)
+    void record(std::size_t value)
+    {
+        std::size_t b = 0;
+        for (std::size_t v = value; v; v >>= 1)
+            ++b;
+        ++counts[b];
+        ++number;
+        sum += value;
+        if (value > largest)
+            largest = value;
+    } // record()
+
+    // Description: Number of values recorded in bucket 'b'.
+    // Runtime: O(1)
+    std::size_t bucket(std::size_t b) const
+    {
+        return counts[b];
+    } // bucket()
+
+    // Description: Number of values recorded.
+    // Runtime: O(1)
+    std::size_t samples() const
+    {
+        return number;
+    } // samples()
+
+    // Description: Sum of the values recorded.
+    // Runtime: O(1)
+    std::size_t total() const
+    {
+        return sum;
+    } // total()
+
+    // Description: Largest value recorded, or 0 if none.
+    // Runtime: O(1)
+    std::size_t max() const
+    {
+        return largest;
+    } // max()
+
+    // Description: Mean of the values recorded, or 0 if none.
+    // Runtime: O(1)
+    double mean() const
+    {
+        return number ? static_cast<double>(sum) / static_cast<double>(number) : 0.0;
+    } // mean()
+
+    // Description: Forget every value.
+    // Runtime: O(BUCKETS)
+    void reset()
+    {
+        for (std::size_t &c : counts)
+            c = 0;
+        number = sum = largest = 0;
+    } // reset()
+
+private:
+    std::size_t counts[BUCKETS];
+    std::size_t number;
+    std::size_t sum;
+    std::size_t largest;
+}; // PQHistogram
+
+// What CountingStats keeps for each PQOp.  'siftLevels' is the number of
+// levels heap elements moved through, in the heaps built on HeapCore.
+struct PQOpCounts
+{
+    std::size_t calls;
+    std::size_t compares;
+    std::size_t moves;
+    std::size_t allocations;
+    std::size_t siftLevels;
+}; // PQOpCounts
+
+// The counting policy.  Each hook charges the operation most recently
+// passed to begin().  The three histograms are kept per queue:
+//   siftDepths()  - levels moved by each sift in the heaps built on
+//                   HeapCore (BinaryPQ and IndexedBinaryPQ)
+//   meldWidths()  - subtrees combined by each pairing pass in PairingPQ,
+//                   which in pop() is the number of children of the root,
+//                   or half trees linked by each pass in RankPairingPQ
+//   scanLengths() - elements examined by each linear search in UnorderedPQ
+//                   and UnorderedFastPQ, or block in BlockedUnorderedPQ
+class CountingStats
+{
+public:
+    static constexpr std::size_t OPS = 5;
+
+    // Description: Construct a policy with every counter at zero.
+    // Runtime: O(1)
+    CountingStats()
+    {
+        reset();
+    } // CountingStats()
+
+    void begin(PQOp op) const
+    {
+        current = static_cast<std::size_t>(op);
+        ++ops[current].calls;
+    }
+
+    void compared() const
+    {
+        ++ops[current].compares;
+    }
+
+    void moved(std::size_t n = 1) const
+    {
+        ops[current].moves += n;
+    }
+
+    void allocated() const
+    {
+        ++ops[current].allocations;
+    }
+
+    void sifted(std::size_t levels) const
+    {
+        ops[current].siftLevels += levels;
+        siftDepth.record(levels);
+    }
+
+    void melded(std::size_t roots) const
+    {
+        meldWidth.record(roots);
+    }
+
+    void scanned(std::size_t length) const
+    {
+        scanLength.record(length);
+    }
+
+    // Description: The counters charged to 'op'.
+    // Runtime: O(1)
+    const PQOpCounts &operator[](PQOp op) const
+    {
+        return ops[static_cast<std::size_t>(op)];
+    } // operator[]()
+
+    // Description: The counters of every operation added together.
+    // Runtime: O(1)
+    PQOpCounts total() const
+    {
+        PQOpCounts sum = {0, 0, 0, 0, 0};
+        for (const PQOpCounts &op : ops)
+        {
+            sum.calls += op.calls;
+            sum.compares += op.compares;
+            sum.moves += op.moves;
+            sum.allocations += op.allocations;
+            sum.siftLevels += op.siftLevels;
+        }
+        return sum;
+    } // total()
+
+    const PQHistogram &siftDepths() const
+    {
+        return siftDepth;
+    } // siftDepths()
+
+    const PQHistogram &meldWidths() const
+    {
+        return meldWidth;
+    } // meldWidths()
+
+    const PQHistogram &scanLengths() const
+    {
+        return scanLength;
+    } // scanLengths()
+
+    // Description: Set every counter back to zero and empty the histograms.
+    // Runtime: O(1)
+    void reset()
+    {
+        for (PQOpCounts &op : ops)
+            op = PQOpCounts{0, 0, 0, 0, 0};
+        current = static_cast<std::size_t>(PQOp::Bulk);
+        siftDepth.reset();
+        meldWidth.reset();
+        scanLength.reset();
+    } // reset()
+
+private:
+    mutable PQOpCounts ops[OPS];
+    mutable std::size_t current; // index in 'ops' of the operation being charged
+    mutable PQHistogram siftDepth;
+    mutable PQHistogram meldWidth;
+    mutable PQHistogram scanLength;
+}; // CountingStats
+
+// Holds a queue's stats policy.  Queues inherit from it privately instead of
+// keeping the policy as a member, so that an empty policy such as NoStats
+// takes no space (the empty base optimization; [[no_unique_address]] would
+// need C++20).  The policy itself is a private base, so its members do not
+// leak into the queue's scope; the queue reaches it through counters().
+template <typename STATS>
+class PQStatsHolder : private STATS
+{
+protected:
+    STATS &counters()
+    {
+        return *this;
+    } // counters()
+
+    const STATS &counters() const
+    {
+        return *this;
+    } // counters()
+}; // PQStatsHolder
+
+// A comparison functor that reports each call to a stats policy before
+// forwarding it, for the standard algorithms a queue hands 'compare' to.
+template <typename COMP_FUNCTOR, typename STATS>
+struct CountedCompare
+{
+    const COMP_FUNCTOR *compare;
+    const STATS *stats;
+
+    template <typename A, typename B>
+    bool operator()(const A &a, const B &b) const
+    {
+        stats->compared();
+        return (*compare)(a, b);
+    }
+}; // CountedCompare
+
+// Picks the comparison functor a queue passes on: a CountedCompare, or,
+// under NoStats, 'compare' itself, so specializations keyed on the functor
+// type (such as the SIMD scan in ExtremeScan.h) still apply.
+template <typename COMP_FUNCTOR, typename STATS>
+struct PQStatsCompare
+{
+    using type = CountedCompare<COMP_FUNCTOR, STATS>;
+
+    static type wrap(const COMP_FUNCTOR &compare, const STATS &stats)
+    {
+        return type{&compare, &stats};
+    }
+}; // PQStatsCompare
+
+template <typename COMP_FUNCTOR>
+struct PQStatsCompare<COMP_FUNCTOR, NoStats>
+{
+    using type = const COMP_FUNCTOR &;
+
+    static type wrap(const COMP_FUNCTOR &compare, const NoStats &)
+    {
+        return compare;
+    }
+}; // PQStatsCompare
+
+#endif // PQSTATS_H
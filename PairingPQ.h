@@ -4,12 +4,18 @@
 #define PAIRINGPQ_H
 
 #include "Eecs281PQ.h"
-#include <deque>
+#include "NodePool.h"
+#include "PQStats.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
 #include <utility>
 
 // A specialized version of the 'priority_queue' ADT implemented as a pairing heap.
-template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class PairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>
+// STATS is the stats policy; see PQStats.h.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename STATS = NoStats>
+class PairingPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS>
 {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
@@ -20,7 +26,12 @@ public:
     {
     public:
         explicit Node(const TYPE &val)
-            : elt{val}, child{nullptr}, sibling{nullptr}, parent{nullptr}
+            : elt{val}, child{nullptr}, sibling{nullptr}, parent{nullptr}, prev{nullptr}
+        {
+        }
+
+        explicit Node(TYPE &&val)
+            : elt{std::move(val)}, child{nullptr}, sibling{nullptr}, parent{nullptr}, prev{nullptr}
         {
         }
 
@@ -41,6 +52,11 @@ public:
         Node *child;
         Node *sibling;
         Node *parent;
+        // The next older sibling, or the parent for the eldest child, so a
+        // node can be unlinked without searching for it.  'parent' is kept
+        // as well, so updateElt() can tell whether a cut is needed at all.
+        // Both are null at the root.
+        Node *prev;
     }; // Node
 
     // Description: Construct an empty priority_queue with an optional comparison functor.
@@ -52,7 +68,11 @@ public:
     } // PairingPQ()
 
     // Description: Construct a priority_queue out of an iterator range with an optional
-    //              comparison functor.
+    //              comparison functor.  Any input iterator will do, including
+    //              single-pass ones such as std::istream_iterator.  The heap
+    //              is built by buildTree() with exactly n - 1 comparisons,
+    //              and when the iterators can be walked more than once, node
+    //              storage for all n elements is reserved up front.
     // Runtime: O(n) where n is number of elements in range.
     template <typename InputIterator>
     PairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) : BaseClass{comp}
@@ -61,82 +81,72 @@ public:
         num_nodes = 0;
         root = nullptr;
 
-        for (InputIterator i = start; i < end; i++)
-        {
-            push(*i);
-        }
-
+        this->counters().begin(PQOp::Bulk);
+        reserveNodes(start, end, typename std::iterator_traits<InputIterator>::iterator_category());
+        root = buildTree(start, end);
     } // PairingPQ()
 
-    // Description: Copy constructor.
+    // Description: Copy constructor.  The source tree is cloned node for node
+    //              in its exact shape, so no elements are compared.
     // Runtime: O(n)
-    PairingPQ(const PairingPQ &other) : BaseClass{other.compare}
+    PairingPQ(const PairingPQ &other) : PairingPQ{other, [](const Node *, Node *) {}}
     {
+    } // PairingPQ()
 
-        // TODO
+    // Description: Copy constructor that also reports where every node was
+    //              copied to: remap(oldNode, newNode) is called once for each
+    //              node of 'other', in preorder, so that Node pointers into
+    //              'other' can be re-targeted at the copy.
+    // Runtime: O(n) plus the calls to 'remap'
+    template <typename Remap>
+    PairingPQ(const PairingPQ &other, Remap remap) : BaseClass{other.compare}
+    {
         num_nodes = 0;
         root = nullptr;
 
-        std::deque<Node *> to_be_inserted;
-
-        to_be_inserted.push_back(other.root);
-
-        while (!to_be_inserted.empty())
+        try
         {
-            Node *next = to_be_inserted.front();
-
-            if (next->child)
-                to_be_inserted.push_back(next->child);
-            if (next->sibling)
-                to_be_inserted.push_back(next->sibling);
-
-            push(next->elt);
-            to_be_inserted.pop_front();
+            cloneTree(other, remap);
         }
-
+        catch (...)
+        {
+            destroyAll();
+            throw;
+        }
+        this->counters() = other.counters();
     } // PairingPQ()
 
     // Description: Copy assignment operator.
     // Runtime: O(n)
-
     PairingPQ &operator=(const PairingPQ &rhs)
     {
         // TODO
         PairingPQ temp(rhs);
-
-        std::swap(num_nodes, temp.num_nodes);
-        std::swap(root, temp.root);
-
+        swapNodes(temp);
         return *this;
     } // operator=()
 
+    // Description: Copy assignment that also calls remap(oldNode, newNode)
+    //              for every node of 'rhs', like the copy constructor above.
+    //              Node pointers into this priority_queue are invalidated, as
+    //              they are by operator=.
+    // Runtime: O(n + m) plus the calls to 'remap', where m is rhs.size()
+    template <typename Remap>
+    void assign(const PairingPQ &rhs, Remap remap)
+    {
+        PairingPQ temp(rhs, remap);
+        swapNodes(temp);
+    } // assign()
+
     // Description: Destructor
-    // Runtime: O(n)
+    // Note: Node storage belongs to the pool and is released in bulk when it
+    //       is destroyed, so the heap only has to be walked when the elements
+    //       themselves have destructors to run.
+    // Runtime: O(n), or O(number of slabs) for trivially destructible TYPE
     ~PairingPQ()
     {
-        // TODO
-        if (!root)
-        {
-        }
-        else
-        {
-            std::deque<Node *> to_be_deleted;
-            to_be_deleted.push_back(root);
-
-            while (!to_be_deleted.empty())
-            {
-                Node *next = to_be_deleted.front();
-                if (next->child)
-                    to_be_deleted.push_back(next->child);
-                if (next->sibling)
-                    to_be_deleted.push_back(next->sibling);
-
-                delete next;
-                next = nullptr;
-                to_be_deleted.pop_front();
-                num_nodes--;
-            }
-        }
+        if (!std::is_trivially_destructible<TYPE>::value)
+            destroyAll();
     } // ~PairingPQ()
 
     // Description: Assumes that all elements inside the priority_queue are out of order and
@@ -145,32 +155,44 @@ public:
     // Runtime: O(n)
     virtual void updatePriorities()
     {
-        // TODO
-        if (!root)
+        this->counters().begin(PQOp::Update);
+        root = mergePairs(unlinkAll());
+    } // updatePriorities()
+
+    // Description: Restore the priority_queue invariant after the elements of
+    //              the nodes in 'changed' have had their priorities changed in
+    //              place, in either direction.  Each such node is cut out with
+    //              its subtree, its children are paired back into one tree of
+    //              their own, and both are melded with the root, so every link
+    //              that could now be out of order is replaced by a fresh one.
+    //              When k log(n) exceeds n, the whole priority_queue is rebuilt
+    //              as by updatePriorities() instead.  Nodes stay valid.
+    // Runtime: Amortized O(k log(n)) where k is changed.size()
+    void updatePriorities(const std::vector<Node *> &changed)
+    {
+        this->counters().begin(PQOp::Update);
+        std::size_t depth = 0;
+        for (std::size_t n = size(); n > 1; n /= 2)
+            ++depth;
+        if (changed.size() * depth > size())
         {
+            root = mergePairs(unlinkAll());
+            return;
         }
-        else
+
+        for (Node *node : changed)
         {
-            std::deque<Node *> to_be_updated;
-            to_be_updated.push_back(root);
+            if (node == root)
+                root = nullptr;
+            else
+                cut(node);
 
-            while (!to_be_updated.empty())
-            {
-                Node *next = to_be_updated.front();
-                if (next->child)
-                    to_be_updated.push_back(next->child);
-                if (next->sibling)
-                    to_be_updated.push_back(next->sibling);
-
-                next->parent = nullptr;
-                next->sibling = nullptr;
-                next->child = nullptr;
-
-                root = meld(next, root);
-                to_be_updated.pop_front();
-            }
+            Node *children = mergePairs(node->child);
+            node->child = nullptr;
+            root = root ? meld(node, root) : node;
+            if (children)
+                root = meld(children, root);
         }
-
     } // updatePriorities()
 
     // Description: Add a new element to the priority_queue. This is already done.
@@ -182,6 +204,47 @@ public:
         addNode(val);
     } // push()
 
+    // Description: Add a new element to the priority_queue, moving from 'val'.
+    // Runtime: O(1)
+    virtual void push(TYPE &&val)
+    {
+        addNode(std::move(val));
+    } // push()
+
+    // Description: Add every element of the range [first, last) to the
+    //              priority_queue.  The new elements are built into a heap of
+    //              their own, which is then melded with the root once.
+    // Runtime: O(m) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        Node *batch = buildTree(first, last);
+        if (!batch)
+            return;
+        root = root ? meld(batch, root) : batch;
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this priority_queue,
+    //              leaving 'other' empty.  The two roots are melded and this
+    //              pool takes over the other pool's storage, so no node is
+    //              copied or moved: Node pointers returned by other.addNode()
+    //              stay valid and now refer into this priority_queue.
+    // Runtime: O(1), plus O(log(m)) bookkeeping for the absorbed pool.
+    void merge(PairingPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        pool.absorb(other.pool);
+        if (other.root)
+            root = root ? meld(other.root, root) : other.root;
+        num_nodes += other.num_nodes;
+        other.root = nullptr;
+        other.num_nodes = 0;
+    } // merge()
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the priority_queue.
     // Note: We will not run tests on your code that would require it to pop an
@@ -191,49 +254,62 @@ public:
     virtual void pop()
     {
         if (empty())
-        {
-        }
-        else if (size() == 1)
-        {
-            delete root;
-            root = nullptr;
-            num_nodes = 0;
-        }
-        else
-        {
-
-            Node *head = root->child;
-            delete root;
-            root = nullptr;
-
-            std::deque<Node *> to_be_melded;
-
-            while (head)
-            {
-                to_be_melded.push_back(head);
-                head->parent = nullptr;
-                head = head->sibling;
-            }
-
-            while (to_be_melded.size() > 1)
-            {
-                Node *p1 = to_be_melded[0], *p2 = to_be_melded[1];
-
-                p1->sibling = nullptr;
-                p2->sibling = nullptr;
-
-                Node *melded = meld(p1, p2);
+            return;
 
-                to_be_melded.push_back(melded);
-                to_be_melded.pop_front();
-                to_be_melded.pop_front();
-            }
+        this->counters().begin(PQOp::Pop);
+        removeRoot();
+    } // pop()
 
-            root = to_be_melded.front();
-            num_nodes--;
+    // Description: Remove the most extreme element from the priority_queue and
+    //              return it, moving it out instead of copying it.
+    // Runtime: Amortized O(log(n))
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(root->elt);
+        removeRoot();
+        return val;
+    } // popTop()
+
+    // Description: Empty the priority_queue into 'out' in sorted order,
+    //              ascending as defined by 'compare', so the most extreme
+    //              element comes last, as extractSorted() does.  Returns the
+    //              output iterator past the last element written.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        std::vector<TYPE> sorted = std::move(*this).extractSorted();
+        this->counters().moved(sorted.size());
+        return std::move(sorted.begin(), sorted.end(), out);
+    } // drainSorted()
+
+    // Description: Empty the priority_queue and return its elements in the
+    //              order drainSorted() writes them.  The tree is taken apart
+    //              with unlinkAll(), each element is moved into a vector as
+    //              its node goes back to the pool, and the vector is sorted,
+    //              which is much kinder to the cache than n pops.  Every
+    //              Node is invalidated.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::vector<TYPE> sorted;
+        sorted.reserve(size());
+        Node *next = unlinkAll();
+        while (next)
+        {
+            Node *node = next;
+            next = next->sibling;
+            sorted.push_back(std::move(node->elt));
+            pool.destroy(node);
         }
-
-    } // pop()
+        num_nodes = 0;
+        this->counters().moved(sorted.size());
+        std::sort(sorted.begin(), sorted.end(), PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+        return sorted;
+    } // extractSorted()
 
     // Description: Return the most extreme (defined by 'compare') element of
     //              the heap.  This should be a reference for speed.  It MUST be
@@ -242,6 +318,7 @@ public:
     // Runtime: O(1)
     virtual const TYPE &top() const
     {
+        this->counters().begin(PQOp::Top);
         return root->elt;
     } // top()
 
@@ -259,53 +336,78 @@ public:
         return root == nullptr;
     } // empty()
 
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
     // Description: Updates the priority of an element already in the priority_queue by
     //              replacing the element refered to by the Node with new_value.
-    //              Must maintain priority_queue invariants.
-    //
-    // PRECONDITION: The new priority, given by 'new_value' must be more extreme
-    //               (as defined by comp) than the old priority.
+    //              Must maintain priority_queue invariants.  The new priority
+    //              may be more or less extreme (as defined by comp) than the
+    //              old one.  A node that becomes more extreme is cut out with
+    //              its subtree and melded with the root if it now beats its
+    //              parent.  A node that becomes less extreme stays where it
+    //              is, and its children are paired into one tree that is
+    //              melded with the root instead.
     //
-    // Runtime: As discussed in reading material.
+    // Runtime: Amortized O(log(n))
     void updateElt(Node *node, const TYPE &new_value)
     {
-        // TODO
+        this->counters().begin(PQOp::Update);
+        bool weaker = lower(new_value, node->elt);
+        this->counters().moved();
         node->elt = new_value;
 
-        if (node == root)
-            return;
-
-        if (this->compare(node->elt, node->parent->elt))
+        if (weaker)
         {
+            Node *children = mergePairs(node->child);
+            node->child = nullptr;
+            if (children)
+                root = meld(children, root);
+            return;
         }
-        else
-        {
-            Node *eldest = node->parent->child;
-            //Leftmost
-            if (eldest == node)
-            {
-                node->parent->child = node->sibling;
-                node->parent = nullptr;
-                node->sibling = nullptr;
-            }
-            //In the middle or rightmost
-            else
-            {
-                Node *temp = eldest;
-                while (temp->sibling != node)
-                {
-                    temp = temp->sibling;
-                }
 
-                temp->sibling = node->sibling;
-                node->parent = nullptr;
-                node->sibling = nullptr;
-            }
+        if (node == root || !lower(node->parent->elt, node->elt))
+            return;
 
-            root = meld(node, root);
-        }
+        cut(node);
+        root = meld(node, root);
     } // updateElt()
 
+    // Description: Remove the element refered to by 'node', which need not be
+    //              the most extreme one, from the priority_queue.  The node is
+    //              cut out with its subtree, its children are paired into one
+    //              tree, and that tree is melded back with the root.  'node'
+    //              is invalid afterwards; every other Node stays valid.
+    // Runtime: Amortized O(log(n))
+    void erase(Node *node)
+    {
+        this->counters().begin(PQOp::Pop);
+        if (node == root)
+        {
+            removeRoot();
+            return;
+        }
+
+        cut(node);
+        Node *children = mergePairs(node->child);
+        pool.destroy(node);
+        num_nodes--;
+        if (children)
+            root = meld(children, root);
+    } // erase()
+
     // Description: Add a new element to the priority_queue. Returns a Node* corresponding
     //              to the newly added element.
     // Runtime: O(1)
@@ -315,57 +417,312 @@ public:
     //       updatePriorities().
     Node *addNode(const TYPE &val)
     {
-        // TODO
+        this->counters().begin(PQOp::Push);
+        return insertNode(construct(val));
+    } // addNode()
+
+    // Description: Add a new element to the priority_queue, moving from 'val'.
+    //              Returns a Node* corresponding to the newly added element.
+    // Runtime: O(1)
+    Node *addNode(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        return insertNode(construct(std::move(val)));
+    } // addNode()
+
+private:
+    // TODO: Add any additional member functions or data you require here.
 
+    Node *root;
+    int num_nodes;
+
+    // Every Node is created and recycled through this pool rather than
+    // with new and delete.
+    NodePool<Node> pool;
+
+    // this->compare, reported to the stats policy.
+    bool lower(const TYPE &a, const TYPE &b) const
+    {
+        this->counters().compared();
+        return this->compare(a, b);
+    }
+
+    // Description: Create a node holding 'val' in the pool.
+    template <typename T>
+    Node *construct(T &&val)
+    {
+        this->counters().allocated();
+        this->counters().moved();
+        return pool.construct(std::forward<T>(val));
+    } // construct()
+
+    // Description: Exchange the nodes (and stats) of two priority_queues.
+    void swapNodes(PairingPQ &other)
+    {
+        std::swap(num_nodes, other.num_nodes);
+        std::swap(root, other.root);
+        pool.swap(other.pool);
+        std::swap(this->counters(), other.counters());
+    } // swapNodes()
+
+    // Description: Destroy every node and leave the priority_queue empty.
+    // Runtime: O(n)
+    void destroyAll()
+    {
+        Node *next = unlinkAll();
+        while (next)
+        {
+            Node *victim = next;
+            next = next->sibling;
+            pool.destroy(victim);
+        }
+        num_nodes = 0;
+    } // destroyAll()
+
+    // Description: Copy the tree of 'other' into this empty priority_queue
+    //              node for node.  A preorder walk of the source climbs back
+    //              up through its parent pointers, and the copy is climbed in
+    //              step through the parent pointers just set, so no stack is
+    //              needed.  Each copy is linked in as soon as it is made, so
+    //              if an element's copy throws, the nodes made so far can
+    //              still be destroyed with destroyAll().
+    // Runtime: O(n)
+    template <typename Remap>
+    void cloneTree(const PairingPQ &other, Remap &remap)
+    {
+        const Node *source = other.root;
+        if (!source)
+            return;
+
+        Node *copy = root = construct(source->elt);
+        remap(source, copy);
+        for (;;)
+        {
+            Node *node = nullptr;
+            if (source->child)
+            {
+                node = construct(source->child->elt);
+                node->parent = copy;
+                node->prev = copy;
+                copy->child = node;
+                source = source->child;
+            }
+            else
+            {
+                while (source != other.root && !source->sibling)
+                {
+                    source = source->parent;
+                    copy = copy->parent;
+                }
+                if (source == other.root)
+                    break;
+                node = construct(source->sibling->elt);
+                node->parent = copy->parent;
+                node->prev = copy;
+                copy->sibling = node;
+                source = source->sibling;
+            }
+            copy = node;
+            remap(source, copy);
+        }
+        num_nodes = other.num_nodes;
+    } // cloneTree()
+
+    // Description: Destroy the root and pair its children into the new root.
+    void removeRoot()
+    {
+        Node *head = root->child;
+        pool.destroy(root);
+        root = mergePairs(head);
+        num_nodes--;
+    } // removeRoot()
+
+    // Description: Meld a freshly created node into the priority_queue.
+    Node *insertNode(Node *n)
+    {
         if (!root)
         {
-            root = new Node(val);
+            root = n;
             num_nodes = 1;
             return root;
         }
 
-        Node *n = new Node(val);
         root = meld(n, root);
         num_nodes++;
         return n;
+    } // insertNode()
 
-    } // addNode()
+    // Description: Detach 'node', which must not be the root, from its parent
+    //              and siblings.  Its own subtree stays attached to it.
+    // Runtime: O(1)
+    void cut(Node *node)
+    {
+        if (node->prev == node->parent)
+            node->parent->child = node->sibling;
+        else
+            node->prev->sibling = node->sibling;
+        if (node->sibling)
+            node->sibling->prev = node->prev;
+        node->parent = nullptr;
+        node->prev = nullptr;
+        node->sibling = nullptr;
+    } // cut()
+
+    // Description: Combine a list of subtrees linked through 'sibling' into a
+    //              single tree using two-pass pairing: meld adjacent pairs left
+    //              to right, then meld the results right to left.  The pairs
+    //              from the first pass are stacked through their own sibling
+    //              pointers, so no auxiliary container is needed.
+    // Runtime: O(k) melds for a list of k subtrees
+    Node *mergePairs(Node *head)
+    {
+        if (!head)
+        {
+            this->counters().melded(0);
+            return nullptr;
+        }
 
-private:
-    // TODO: Add any additional member functions or data you require here.
+        Node *pairs = nullptr;
+        std::size_t width = 0;
+        while (head)
+        {
+            Node *first = head;
+            Node *second = first->sibling;
+            head = second ? second->sibling : nullptr;
+
+            first->parent = nullptr;
+            first->prev = nullptr;
+            first->sibling = nullptr;
+            ++width;
+            if (second)
+            {
+                ++width;
+                second->parent = nullptr;
+                second->prev = nullptr;
+                second->sibling = nullptr;
+                first = meld(first, second);
+            }
 
-    Node *root;
-    int num_nodes;
+            first->sibling = pairs;
+            pairs = first;
+        }
 
-    Node *meld(Node *p1, Node *r)
+        Node *result = pairs;
+        pairs = pairs->sibling;
+        result->sibling = nullptr;
+        while (pairs)
+        {
+            Node *next = pairs->sibling;
+            pairs->sibling = nullptr;
+            result = meld(pairs, result);
+            pairs = next;
+        }
+        this->counters().melded(width);
+        return result;
+    } // mergePairs()
+
+    // Description: Create a node for every element of [first, last) and
+    //              build them into one tree with multipass (tournament)
+    //              pairing, done online: slots[r] holds a tree of 2^r nodes,
+    //              and each new node carries through the slots like a binary
+    //              counter, so every meld joins two trees of equal size.  That
+    //              takes exactly m - 1 comparisons, leaves the root with only
+    //              O(log(m)) children, and touches each node while it is
+    //              still in cache.
+    // Runtime: O(m) where m is number of elements in range.
+    template <typename InputIterator>
+    Node *buildTree(InputIterator first, InputIterator last)
     {
-        if (p1 == r)
-            return p1;
-
-        if (this->compare(p1->elt, r->elt))
+        Node *slots[std::numeric_limits<std::size_t>::digits] = {};
+        for (; first != last; ++first)
         {
-            p1->parent = r;
-            if (r->child)
+            Node *carry = construct(*first);
+            num_nodes++;
+
+            std::size_t rank = 0;
+            for (; slots[rank]; ++rank)
             {
-                p1->sibling = r->child;
+                carry = meld(slots[rank], carry);
+                slots[rank] = nullptr;
             }
-            r->child = p1;
-            return r;
+            slots[rank] = carry;
         }
-        else
+
+        Node *result = nullptr;
+        for (Node *tree : slots)
+            if (tree)
+                result = result ? meld(tree, result) : tree;
+        return result;
+    } // buildTree()
+
+    // Description: Reserve pool storage for the nodes of [first, last) when
+    //              the range can be measured without consuming it.
+    template <typename ForwardIterator>
+    void reserveNodes(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+    {
+        pool.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    } // reserveNodes()
+
+    template <typename InputIterator>
+    void reserveNodes(InputIterator, InputIterator, std::input_iterator_tag)
+    {
+    } // reserveNodes()
+
+    // Description: Take every node out of the tree and return them as one list
+    //              linked through 'sibling', with 'child', 'parent' and 'prev'
+    //              cleared.  Whenever the current node has a child, the tree is
+    //              rotated so that child comes first (viewing 'child' as left
+    //              and 'sibling' as right), which visits every node in constant
+    //              extra space.
+    // Runtime: O(n)
+    Node *unlinkAll()
+    {
+        Node *list = nullptr;
+        Node *current = root;
+        while (current)
         {
-            r->parent = p1;
-            if (p1->child)
+            if (current->child)
             {
-                r->sibling = p1->child;
-                p1->child = r;
+                Node *first = current->child;
+                current->child = first->sibling;
+                first->sibling = current;
+                current = first;
             }
             else
-                p1->child = r;
-
-            return p1;
+            {
+                Node *next = current->sibling;
+                current->parent = nullptr;
+                current->prev = nullptr;
+                current->sibling = list;
+                list = current;
+                current = next;
+            }
         }
-        return r;
+        root = nullptr;
+        return list;
+    } // unlinkAll()
+
+    // Make the root with the less extreme element the eldest child of the
+    // other, and return the new root.  The winner is picked with selects
+    // rather than a branch, since melds of unrelated subtrees (as in
+    // buildTree() and mergePairs()) are a coin flip the branch predictor
+    // cannot learn.
+    Node *meld(Node *p1, Node *r)
+    {
+        if (p1 == r)
+            return p1;
+
+        Node *pair[2] = {p1, r};
+        std::size_t rWins = lower(p1->elt, r->elt);
+        Node *winner = pair[rWins];
+        Node *loser = pair[1 - rWins];
+        loser->parent = winner;
+        loser->prev = winner;
+        loser->sibling = winner->child;
+        if (winner->child)
+            winner->child->prev = loser;
+        winner->child = loser;
+        return winner;
     }
 };
 
@@ -0,0 +1,301 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef RADIXPQ_H
+#define RADIXPQ_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "Eecs281PQ.h"
+
+// The default key extractor for RadixPQ: the element is its own key.
+struct RadixIdentity
+{
+    template <typename TYPE>
+    const TYPE &operator()(const TYPE &val) const
+    {
+        return val;
+    }
+}; // RadixIdentity
+
+// The comparison functor a RadixPQ hands to Eecs281PQ: an element is lower
+// priority than another when its key is larger, so top() is the element
+// with the smallest key.
+template <typename TYPE, typename KEY_OF>
+struct RadixKeyGreater
+{
+    KEY_OF keyOf;
+
+    bool operator()(const TYPE &a, const TYPE &b) const
+    {
+        return keyOf(b) < keyOf(a);
+    }
+}; // RadixKeyGreater
+
+// A monotone radix heap: a min-priority queue over unsigned integer keys for
+// workloads whose popped keys never decrease, such as event times or
+// Dijkstra distances.  TYPE is either the key itself or any element from
+// which KEY_OF extracts one, e.g. a (distance, vertex) pair.
+//
+// Every element lives in one of the buckets 0..KEY_BITS, chosen by the
+// highest bit in which its key differs from 'last', the key most recently
+// popped: bucket 0 holds keys equal to 'last', bucket b keys that first
+// differ from it in bit b - 1.  pop() takes from bucket 0; when that is
+// empty, it moves 'last' up to the smallest key of the lowest non-empty
+// bucket and redistributes that bucket, whose elements all land in strictly
+// lower buckets.  An element can therefore only move down, at most KEY_BITS
+// times, and no element is ever compared with another except to find a
+// bucket's minimum.
+//
+// PRECONDITION: Every key pushed must be at least the key of the element
+//               most recently popped.  This is checked by assert() in debug
+//               builds.
+template <typename TYPE, typename KEY_OF = RadixIdentity>
+class RadixPQ final : public Eecs281PQ<TYPE, RadixKeyGreater<TYPE, KEY_OF>>
+{
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, RadixKeyGreater<TYPE, KEY_OF>>;
+
+    using Key = typename std::decay<decltype(std::declval<const KEY_OF &>()(std::declval<const TYPE &>()))>::type;
+    static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+                  "RadixPQ needs an unsigned integer key");
+
+    static const std::size_t KEY_BITS = std::numeric_limits<Key>::digits;
+    static const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+public:
+    // Description: Construct an empty heap with an optional key extractor.
+    // Runtime: O(1)
+    explicit RadixPQ(KEY_OF keyOf = KEY_OF())
+        : BaseClass{RadixKeyGreater<TYPE, KEY_OF>{keyOf}}, last{0}, count{0}, minBucket{NONE}, minIndex{0}
+    {
+    } // RadixPQ
+
+    // Description: Construct a heap out of an iterator range with an optional
+    //              key extractor.
+    // Runtime: O(n) where n is number of elements in range.
+    template <typename InputIterator>
+    RadixPQ(InputIterator start, InputIterator end, KEY_OF keyOf = KEY_OF())
+        : RadixPQ{keyOf}
+    {
+        for (; start != end; ++start)
+            push(*start);
+    } // RadixPQ
+
+    // Description: Destructor doesn't need any code, the buckets will be
+    //              destroyed automatically.
+    virtual ~RadixPQ()
+    {
+    } // ~RadixPQ()
+
+    // Description: Assumes that the keys of the elements have changed and
+    //              redistributes every element.  Keys may have moved in either
+    //              direction; if any is now below the last popped key, that
+    //              bound drops to the smallest key present, and later pushes
+    //              are checked against it.
+    // Runtime: O(n)
+    virtual void updatePriorities()
+    {
+        std::vector<TYPE> all;
+        all.reserve(count);
+        for (std::vector<TYPE> &bucket : buckets)
+        {
+            for (TYPE &val : bucket)
+                all.push_back(std::move(val));
+            bucket.clear();
+        }
+
+        for (const TYPE &val : all)
+            if (keyOf(val) < last)
+                last = keyOf(val);
+        for (TYPE &val : all)
+            buckets[bucketOf(keyOf(val))].push_back(std::move(val));
+        minBucket = NONE;
+    } // updatePriorities()
+
+    // Description: Add a new element to the heap.
+    // Runtime: Amortized O(1)
+    virtual void push(const TYPE &val)
+    {
+        place(val);
+        buckets[bucketOf(keyOf(val))].push_back(val);
+        ++count;
+    } // push()
+
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val)
+    {
+        place(val);
+        buckets[bucketOf(keyOf(val))].push_back(std::move(val));
+        ++count;
+    } // push()
+
+    // Description: Remove the element with the smallest key from the heap.
+    // Note: We will not run tests on your code that would require it to pop an
+    // element when the heap is empty. Though you are welcome to if you are
+    // familiar with them, you do not need to use exceptions in this project.
+    // Runtime: Amortized O(KEY_BITS), i.e. O(log C) for keys below C
+    virtual void pop()
+    {
+        if (buckets[0].empty())
+            refill();
+        buckets[0].pop_back();
+        --count;
+    } // pop()
+
+    // Description: Remove the element with the smallest key from the heap and
+    //              return it, moving it out instead of copying it.
+    // Runtime: Amortized O(KEY_BITS)
+    virtual TYPE popTop()
+    {
+        if (buckets[0].empty())
+            refill();
+        TYPE val = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        --count;
+        return val;
+    } // popTop()
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', i.e. by decreasing key, so the
+    //              smallest key comes last.  Returns the output iterator past
+    //              the last element written.  Later pushes are checked
+    //              against the largest key drained, as if every element had
+    //              been popped.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        std::vector<TYPE> sorted = std::move(*this).extractSorted();
+        return std::move(sorted.begin(), sorted.end(), out);
+    } // drainSorted()
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them.  The buckets are gathered and
+    //              sorted by key, without redistributing anything.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        std::vector<TYPE> sorted;
+        sorted.reserve(count);
+        for (std::vector<TYPE> &bucket : buckets)
+        {
+            for (TYPE &val : bucket)
+                sorted.push_back(std::move(val));
+            bucket.clear();
+        }
+        std::sort(sorted.begin(), sorted.end(), this->compare);
+        if (!sorted.empty())
+            last = keyOf(sorted.front());
+        count = 0;
+        minBucket = NONE;
+        return sorted;
+    } // extractSorted()
+
+    // Description: Return the element with the smallest key.  Its position is
+    //              remembered, so a following pop() does not search again.
+    // Runtime: O(1) when the smallest key equals the last one popped,
+    //          otherwise linear in the size of the lowest non-empty bucket.
+    virtual const TYPE &top() const
+    {
+        if (!buckets[0].empty())
+            return buckets[0].back();
+        if (minBucket == NONE)
+            findMin();
+        return buckets[minBucket][minIndex];
+    } // top()
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const
+    {
+        return count;
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const
+    {
+        return count == 0;
+    } // empty()
+
+private:
+    // buckets[b] holds the elements whose keys first differ from 'last' in
+    // bit b - 1; buckets[0] those equal to it.
+    std::vector<TYPE> buckets[KEY_BITS + 1];
+    Key last;
+    std::size_t count;
+
+    // Where top() found the smallest element while buckets[0] was empty, or
+    // minBucket == NONE if that is not known.
+    mutable std::size_t minBucket;
+    mutable std::size_t minIndex;
+
+    Key keyOf(const TYPE &val) const
+    {
+        return this->compare.keyOf(val);
+    }
+
+    // Index of the bucket for 'key' relative to 'last'.
+    std::size_t bucketOf(Key key) const
+    {
+        unsigned long long diff = static_cast<unsigned long long>(key ^ last);
+        if (diff == 0)
+            return 0;
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits - __builtin_clzll(diff));
+#else
+        std::size_t width = 0;
+        for (; diff; diff >>= 1)
+            ++width;
+        return width;
+#endif
+    }
+
+    // Check the monotonicity precondition for a new element, and forget the
+    // remembered minimum if the new element beats it.
+    void place(const TYPE &val)
+    {
+        assert(keyOf(val) >= last && "RadixPQ: key pushed below the last key popped");
+        if (minBucket != NONE && this->compare(buckets[minBucket][minIndex], val))
+            minBucket = NONE;
+    }
+
+    // Find the smallest element of the lowest non-empty bucket, which is the
+    // smallest element overall when buckets[0] is empty.
+    void findMin() const
+    {
+        std::size_t b = 1;
+        while (buckets[b].empty())
+            ++b;
+
+        const std::vector<TYPE> &bucket = buckets[b];
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < bucket.size(); ++i)
+            if (this->compare(bucket[best], bucket[i]))
+                best = i;
+        minBucket = b;
+        minIndex = best;
+    }
+
+    // Advance 'last' to the smallest key and redistribute its bucket, which
+    // moves at least that element into buckets[0].
+    void refill()
+    {
+        if (minBucket == NONE)
+            findMin();
+
+        std::vector<TYPE> &bucket = buckets[minBucket];
+        last = keyOf(bucket[minIndex]);
+        for (TYPE &val : bucket)
+            buckets[bucketOf(keyOf(val))].push_back(std::move(val));
+        bucket.clear();
+        minBucket = NONE;
+    }
+}; // RadixPQ
+
+#endif // RADIXPQ_H
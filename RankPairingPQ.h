@@ -0,0 +1,745 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+#ifndef RANKPAIRINGPQ_H
+#define RANKPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include "NodePool.h"
+#include "PQStats.h"
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A specialized version of the 'priority_queue' ADT implemented as a
+// rank-pairing heap (Haeupler, Sen and Tarjan), with the same Node handle
+// API as PairingPQ.  Where a pairing heap only promises amortized O(log(n))
+// for a decrease-key, this one does it in amortized O(1), while pop() stays
+// amortized O(log(n)).
+//
+// The heap is a circular list of half trees.  A half tree is a binary tree
+// whose root has no right child, ordered only along left links: every node
+// is no more extreme than the nodes whose left subtree it is in.  Each node
+// has a rank, and two half trees are only ever linked when their ranks are
+// equal (the winner's rank goes up by one), which keeps ranks, and so the
+// number of trees left by a pop, logarithmic.  A decrease-key cuts the node
+// out with its left subtree as a new half tree, moves its right subtree up
+// into its place, and lowers the ranks of its ancestors until one does not
+// change.  That uses the type-2 rule, which lets sibling ranks drift further
+// apart than type-1 does and so ends those walks sooner.  Pops link the
+// roots in one pass.  The roots are linked through their free 'right'
+// pointers, and 'minRoot' points at the most extreme one.
+// STATS is the stats policy; see PQStats.h.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename STATS = NoStats>
+class RankPairingPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS>
+{
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Each node within the rank-pairing heap
+    class Node
+    {
+    public:
+        explicit Node(const TYPE &val)
+            : elt{val}, left{nullptr}, right{nullptr}, parent{nullptr}, rank{0}
+        {
+        }
+
+        explicit Node(TYPE &&val)
+            : elt{std::move(val)}, left{nullptr}, right{nullptr}, parent{nullptr}, rank{0}
+        {
+        }
+
+        // Description: Allows access to the element at that Node's position.
+        // Runtime: O(1)
+        const TYPE &getElt() const { return elt; }
+        const TYPE &operator*() const { return elt; }
+
+        friend RankPairingPQ;
+
+    private:
+        TYPE elt;
+        Node *left;
+        // The right child, or for a root, the next root in the list.
+        Node *right;
+        // Null at a root.
+        Node *parent;
+        int rank;
+    }; // Node
+
+    // Description: Construct an empty priority_queue with an optional comparison functor.
+    // Runtime: O(1)
+    explicit RankPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass{comp}, minRoot{nullptr}, num_nodes{0}
+    {
+    } // RankPairingPQ()
+
+    // Description: Construct a priority_queue out of an iterator range with an
+    //              optional comparison functor.  The nodes are linked into
+    //              half trees as by updatePriorities(), with n - 1
+    //              comparisons.
+    // Runtime: O(n) where n is number of elements in range.
+    template <typename InputIterator>
+    RankPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
+        : BaseClass{comp}, minRoot{nullptr}, num_nodes{0}
+    {
+        this->counters().begin(PQOp::Bulk);
+        Node *list = nullptr;
+        try
+        {
+            for (; start != end; ++start)
+            {
+                Node *node = construct(*start);
+                node->right = list;
+                list = node;
+                num_nodes++;
+            }
+        }
+        catch (...)
+        {
+            destroyList(list);
+            throw;
+        }
+        linkAll(list);
+    } // RankPairingPQ()
+
+    // Description: Copy constructor.  The elements of 'other' are copied into
+    //              fresh nodes, which are linked as by updatePriorities(), so
+    //              Node pointers into 'other' have no counterpart in the copy.
+    // Runtime: O(n)
+    RankPairingPQ(const RankPairingPQ &other)
+        : BaseClass{other.compare}, minRoot{nullptr}, num_nodes{0}
+    {
+        Node *list = nullptr;
+        try
+        {
+            std::vector<const Node *> pending;
+            if (other.minRoot)
+                pending.push_back(other.minRoot);
+            // Every node but the roots is reached through its parent; the
+            // roots are reached in turn through the list, up to minRoot.
+            while (!pending.empty())
+            {
+                const Node *source = pending.back();
+                pending.pop_back();
+                Node *node = construct(source->elt);
+                node->right = list;
+                list = node;
+                num_nodes++;
+                if (source->left)
+                    pending.push_back(source->left);
+                if (source->right && source->right != other.minRoot)
+                    pending.push_back(source->right);
+            }
+        }
+        catch (...)
+        {
+            destroyList(list);
+            throw;
+        }
+        linkAll(list);
+        this->counters() = other.counters();
+    } // RankPairingPQ()
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    RankPairingPQ &operator=(const RankPairingPQ &rhs)
+    {
+        RankPairingPQ temp(rhs);
+        std::swap(minRoot, temp.minRoot);
+        std::swap(num_nodes, temp.num_nodes);
+        pool.swap(temp.pool);
+        std::swap(this->counters(), temp.counters());
+        return *this;
+    } // operator=()
+
+    // Description: Destructor.  Node storage belongs to the pool, so the heap
+    //              only has to be walked when the elements have destructors
+    //              to run.
+    // Runtime: O(n), or O(number of slabs) for trivially destructible TYPE
+    ~RankPairingPQ()
+    {
+        if (!std::is_trivially_destructible<TYPE>::value)
+            destroyList(unlinkAll());
+    } // ~RankPairingPQ()
+
+    // Description: Assumes that all elements inside the priority_queue are out
+    //              of order and rebuilds it: every node is taken out of its
+    //              half tree, and they are linked again with n - 1
+    //              comparisons, equal ranks only, as by a binary counter.
+    //              Nodes stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities()
+    {
+        this->counters().begin(PQOp::Update);
+        linkAll(unlinkAll());
+    } // updatePriorities()
+
+    // Description: Restore the priority_queue invariant after the elements of
+    //              the nodes in 'changed' have had their priorities changed in
+    //              place, in either direction.  Each such node is cut out,
+    //              the right spine of its left subtree is split into half
+    //              trees of their own, and the roots are then relinked once,
+    //              as by a pop.  When k log(n) exceeds n, the whole
+    //              priority_queue is rebuilt as by updatePriorities()
+    //              instead.  Nodes stay valid.
+    // Runtime: Amortized O(k log(n)) where k is changed.size()
+    void updatePriorities(const std::vector<Node *> &changed)
+    {
+        this->counters().begin(PQOp::Update);
+        std::size_t depth = 0;
+        for (std::size_t n = size(); n > 1; n /= 2)
+            ++depth;
+        if (changed.size() * depth > size())
+        {
+            linkAll(unlinkAll());
+            return;
+        }
+        if (changed.empty())
+            return;
+
+        for (Node *node : changed)
+        {
+            if (node->parent)
+                cut(node);
+            for (Node *spine = node->left; spine;)
+            {
+                Node *next = spine->right;
+                addRoot(detachSpine(spine));
+                spine = next;
+            }
+            node->left = nullptr;
+            node->rank = 0;
+        }
+        relink(minRoot, true);
+    } // updatePriorities()
+
+    // Description: Add a new element to the priority_queue.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val)
+    {
+        addNode(val);
+    } // push()
+
+    // Description: Add a new element to the priority_queue, moving from 'val'.
+    // Runtime: O(1)
+    virtual void push(TYPE &&val)
+    {
+        addNode(std::move(val));
+    } // push()
+
+    // Description: Add every element of the range [first, last) to the
+    //              priority_queue, each as a half tree of its own; the next
+    //              pop links them with the rest.
+    // Runtime: O(m) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        for (; first != last; ++first)
+        {
+            addRoot(construct(*first));
+            num_nodes++;
+        }
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this priority_queue,
+    //              leaving 'other' empty.  The two root lists are spliced
+    //              together and this pool takes over the other pool's
+    //              storage, so Node pointers returned by other.addNode() stay
+    //              valid and now refer into this priority_queue.
+    // Runtime: O(1), plus O(log(m)) bookkeeping for the absorbed pool.
+    void merge(RankPairingPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        pool.absorb(other.pool);
+        if (other.minRoot)
+        {
+            if (!minRoot)
+                minRoot = other.minRoot;
+            else
+            {
+                std::swap(minRoot->right, other.minRoot->right);
+                if (lower(minRoot->elt, other.minRoot->elt))
+                    minRoot = other.minRoot;
+            }
+        }
+        num_nodes += other.num_nodes;
+        other.minRoot = nullptr;
+        other.num_nodes = 0;
+    } // merge()
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the priority_queue.
+    // Runtime: Amortized O(log(n))
+    virtual void pop()
+    {
+        if (empty())
+            return;
+
+        this->counters().begin(PQOp::Pop);
+        removeMin();
+    } // pop()
+
+    // Description: Remove the most extreme element from the priority_queue and
+    //              return it, moving it out instead of copying it.
+    // Runtime: Amortized O(log(n))
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(minRoot->elt);
+        removeMin();
+        return val;
+    } // popTop()
+
+    // Description: Empty the priority_queue into 'out' in sorted order,
+    //              ascending as defined by 'compare', so the most extreme
+    //              element comes last, as extractSorted() does.  Returns the
+    //              output iterator past the last element written.
+    // Runtime: O(n log(n))
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        std::vector<TYPE> sorted = std::move(*this).extractSorted();
+        this->counters().moved(sorted.size());
+        return std::move(sorted.begin(), sorted.end(), out);
+    } // drainSorted()
+
+    // Description: Empty the priority_queue and return its elements in the
+    //              order drainSorted() writes them: the nodes are unlinked,
+    //              each element is moved out as its node goes back to the
+    //              pool, and the elements are sorted.  Every Node is
+    //              invalidated.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::vector<TYPE> sorted;
+        sorted.reserve(size());
+        Node *next = unlinkAll();
+        while (next)
+        {
+            Node *node = next;
+            next = next->right;
+            sorted.push_back(std::move(node->elt));
+            pool.destroy(node);
+        }
+        num_nodes = 0;
+        this->counters().moved(sorted.size());
+        std::sort(sorted.begin(), sorted.end(), PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+        return sorted;
+    } // extractSorted()
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const
+    {
+        this->counters().begin(PQOp::Top);
+        return minRoot->elt;
+    } // top()
+
+    // Description: Get the number of elements in the priority_queue.
+    // Runtime: O(1)
+    virtual std::size_t size() const
+    {
+        return num_nodes;
+    } // size()
+
+    // Description: Return true if the priority_queue is empty.
+    // Runtime: O(1)
+    virtual bool empty() const
+    {
+        return minRoot == nullptr;
+    } // empty()
+
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
+    // Description: Updates the priority of an element already in the
+    //              priority_queue by replacing the element refered to by the
+    //              Node with new_value.  The new priority may be more or less
+    //              extreme (as defined by comp) than the old one.  A node
+    //              that becomes more extreme is cut out as a half tree of
+    //              its own, unless it is a left child that still does not
+    //              beat its parent.  A node that becomes less extreme is
+    //              cut out as well, and the right spine of its left subtree
+    //              is split into half trees of their own, as by a pop.
+    // Runtime: Amortized O(1) if more extreme, otherwise amortized O(log(n))
+    void updateElt(Node *node, const TYPE &new_value)
+    {
+        this->counters().begin(PQOp::Update);
+        bool weaker = lower(new_value, node->elt);
+        this->counters().moved();
+        node->elt = new_value;
+
+        if (!weaker)
+        {
+            if (!node->parent)
+            {
+                if (node != minRoot && lower(minRoot->elt, node->elt))
+                    minRoot = node;
+            }
+            else if (node != node->parent->left || lower(node->parent->elt, node->elt))
+                cut(node);
+            return;
+        }
+
+        if (node->parent)
+            cut(node);
+        if (node == minRoot)
+        {
+            relink(node, true);
+            return;
+        }
+        for (Node *spine = node->left; spine;)
+        {
+            Node *next = spine->right;
+            addRoot(detachSpine(spine));
+            spine = next;
+        }
+        node->left = nullptr;
+        node->rank = 0;
+    } // updateElt()
+
+    // Description: Remove the element refered to by 'node', which need not be
+    //              the most extreme one, from the priority_queue.  The node is
+    //              cut out as a half tree of its own and then removed as the
+    //              root is by pop().  'node' is invalid afterwards; every other
+    //              Node stays valid.
+    // Runtime: Amortized O(log(n))
+    void erase(Node *node)
+    {
+        this->counters().begin(PQOp::Pop);
+        if (node->parent)
+            cut(node);
+        minRoot = node;
+        removeMin();
+    } // erase()
+
+    // Description: Add a new element to the priority_queue. Returns a Node*
+    //              corresponding to the newly added element, which stays valid
+    //              until that element is popped or erased.
+    // Runtime: O(1)
+    Node *addNode(const TYPE &val)
+    {
+        this->counters().begin(PQOp::Push);
+        Node *node = construct(val);
+        addRoot(node);
+        num_nodes++;
+        return node;
+    } // addNode()
+
+    // Description: Add a new element to the priority_queue, moving from 'val'.
+    //              Returns a Node* corresponding to the newly added element.
+    // Runtime: O(1)
+    Node *addNode(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        Node *node = construct(std::move(val));
+        addRoot(node);
+        num_nodes++;
+        return node;
+    } // addNode()
+
+private:
+    Node *minRoot;
+    std::size_t num_nodes;
+
+    // Every Node is created and recycled through this pool rather than
+    // with new and delete.
+    NodePool<Node> pool;
+
+    // buckets[r] holds a half tree of rank r waiting for a partner while
+    // the roots are relinked, and is null between operations.
+    std::vector<Node *> buckets;
+
+
+    // this->compare, reported to the stats policy.
+    bool lower(const TYPE &a, const TYPE &b) const
+    {
+        this->counters().compared();
+        return this->compare(a, b);
+    }
+
+    // The rank of a possibly missing child, which counts as -1.
+    static int rankOf(const Node *node)
+    {
+        return node ? node->rank : -1;
+    }
+
+    // Description: Create a node holding 'val' in the pool.
+    template <typename T>
+    Node *construct(T &&val)
+    {
+        this->counters().allocated();
+        this->counters().moved();
+        return pool.construct(std::forward<T>(val));
+    } // construct()
+
+    // Description: Destroy every node of a list linked through 'right'.
+    void destroyList(Node *list)
+    {
+        while (list)
+        {
+            Node *victim = list;
+            list = list->right;
+            pool.destroy(victim);
+        }
+    } // destroyList()
+
+    // Description: Add the half tree rooted at 'node' to the root list, just
+    //              after minRoot, and make it minRoot if it is more extreme.
+    // Runtime: O(1)
+    void addRoot(Node *node)
+    {
+        node->parent = nullptr;
+        if (!minRoot)
+        {
+            node->right = node;
+            minRoot = node;
+            return;
+        }
+        node->right = minRoot->right;
+        minRoot->right = node;
+        if (lower(minRoot->elt, node->elt))
+            minRoot = node;
+    } // addRoot()
+
+    // Description: Turn 'node', on the right spine below a root that is being
+    //              taken apart, into a half tree of its own: its right
+    //              subtree is dropped (the caller goes on to it), and it
+    //              takes the rank of a root over its left subtree.
+    Node *detachSpine(Node *node)
+    {
+        node->right = nullptr;
+        node->parent = nullptr;
+        node->rank = rankOf(node->left) + 1;
+        return node;
+    } // detachSpine()
+
+    // Description: Make the root with the less extreme element the left child
+    //              of the other, whose old left subtree becomes the loser's
+    //              right subtree, and return the winner with its rank raised
+    //              by one.  The two are equal in rank.
+    Node *link(Node *a, Node *b)
+    {
+        Node *pair[2] = {a, b};
+        std::size_t bWins = lower(a->elt, b->elt);
+        Node *winner = pair[bWins];
+        Node *loser = pair[1 - bWins];
+        loser->right = winner->left;
+        if (winner->left)
+            winner->left->parent = loser;
+        loser->parent = winner;
+        winner->left = loser;
+        winner->rank++;
+        return winner;
+    }
+
+    // Description: Cut 'node', which is not a root, out with its left subtree
+    //              as a new half tree, moving its right subtree up into its
+    //              place, then lower the ranks of its former ancestors by the
+    //              type-2 rule: a node whose children have ranks r1 and r2
+    //              gets rank max(r1, r2) if they differ by more than one and
+    //              max(r1, r2) + 1 if not, a root gets one more than its left
+    //              child, and the walk stops at the first rank that would not
+    //              go down.
+    // Runtime: Amortized O(1)
+    void cut(Node *node)
+    {
+        Node *up = node->parent;
+        Node *moved = node->right;
+        if (up->left == node)
+            up->left = moved;
+        else
+            up->right = moved;
+        if (moved)
+            moved->parent = up;
+        node->rank = rankOf(node->left) + 1;
+        addRoot(node);
+
+        while (up->parent)
+        {
+            int r1 = rankOf(up->left);
+            int r2 = rankOf(up->right);
+            int rank = std::max(r1, r2) + (r1 - r2 > 1 || r2 - r1 > 1 ? 0 : 1);
+            if (rank >= up->rank)
+                return;
+            up->rank = rank;
+            up = up->parent;
+        }
+        up->rank = rankOf(up->left) + 1;
+    } // cut()
+
+    // Description: Remove minRoot, and destroy it.
+    void removeMin()
+    {
+        Node *victim = minRoot;
+        relink(victim, false);
+        pool.destroy(victim);
+        num_nodes--;
+    } // removeMin()
+
+    // Description: Rebuild the root list without 'old', the current minRoot:
+    //              its left spine is split into half trees, and those and
+    //              the other roots (and 'old' itself, as a single node, if
+    //              'keep') are linked in one pass: each tree waits in its
+    //              rank's bucket until a second of the same rank arrives, and
+    //              the two are linked and set aside.  minRoot is then found
+    //              among what is left.
+    // Runtime: Amortized O(log(n))
+    void relink(Node *old, bool keep)
+    {
+        Node *linked = nullptr;
+        std::size_t width = 0;
+        for (Node *root = old->right; root != old;)
+        {
+            Node *next = root->right;
+            place(root, linked);
+            root = next;
+            ++width;
+        }
+        for (Node *spine = old->left; spine;)
+        {
+            Node *next = spine->right;
+            place(detachSpine(spine), linked);
+            spine = next;
+            ++width;
+        }
+        old->left = nullptr;
+        if (keep)
+        {
+            old->rank = 0;
+            place(old, linked);
+            ++width;
+        }
+        this->counters().melded(width);
+
+        minRoot = nullptr;
+        for (Node *&bucket : buckets)
+            if (bucket)
+            {
+                addRoot(bucket);
+                bucket = nullptr;
+            }
+        while (linked)
+        {
+            Node *next = linked->right;
+            addRoot(linked);
+            linked = next;
+        }
+    } // relink()
+
+    // Description: One step of the one-pass linking in relink(): link 'tree'
+    //              with the tree waiting in its rank's bucket, if any, and
+    //              push the result onto 'linked', or else leave it waiting.
+    void place(Node *tree, Node *&linked)
+    {
+        std::size_t rank = static_cast<std::size_t>(tree->rank);
+        if (rank >= buckets.size())
+            buckets.resize(rank + 1, nullptr);
+        if (!buckets[rank])
+        {
+            buckets[rank] = tree;
+            return;
+        }
+        Node *winner = link(buckets[rank], tree);
+        buckets[rank] = nullptr;
+        winner->right = linked;
+        linked = winner;
+    } // place()
+
+    // Description: Link a list of single nodes, linked through 'right', into
+    //              as few half trees as a binary counter gives: each node
+    //              carries through the buckets until it finds an empty one,
+    //              so every link joins two trees of equal rank.  That takes
+    //              exactly m - 1 comparisons for m nodes, plus one for each
+    //              tree added to the root list.
+    // Runtime: O(m)
+    void linkAll(Node *list)
+    {
+        while (list)
+        {
+            Node *carry = list;
+            list = list->right;
+            carry->right = nullptr;
+            for (;;)
+            {
+                std::size_t rank = static_cast<std::size_t>(carry->rank);
+                if (rank >= buckets.size())
+                    buckets.resize(rank + 1, nullptr);
+                if (!buckets[rank])
+                {
+                    buckets[rank] = carry;
+                    break;
+                }
+                carry = link(buckets[rank], carry);
+                buckets[rank] = nullptr;
+            }
+        }
+        for (Node *&bucket : buckets)
+            if (bucket)
+            {
+                addRoot(bucket);
+                bucket = nullptr;
+            }
+    } // linkAll()
+
+    // Description: Take every node out of the heap and return them as one
+    //              list linked through 'right', as single nodes of rank 0.
+    //              With the root list opened up, the whole heap is one binary
+    //              tree, which is flattened by rotating each left child up
+    //              into place, in constant extra space.
+    // Runtime: O(n)
+    Node *unlinkAll()
+    {
+        if (!minRoot)
+            return nullptr;
+
+        Node *current = minRoot->right;
+        minRoot->right = nullptr;
+        minRoot = nullptr;
+        Node *list = nullptr;
+        while (current)
+        {
+            if (current->left)
+            {
+                Node *first = current->left;
+                current->left = first->right;
+                first->right = current;
+                current = first;
+            }
+            else
+            {
+                Node *next = current->right;
+                current->parent = nullptr;
+                current->rank = 0;
+                current->right = list;
+                list = current;
+                current = next;
+            }
+        }
+        return list;
+    } // unlinkAll()
+};
+
+#endif // RANKPAIRINGPQ_H
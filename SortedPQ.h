@@ -4,8 +4,10 @@
 #define SORTEDPQ_H
 
 #include "Eecs281PQ.h"
+#include "PQStats.h"
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <utility>
 
 // A specialized version of the 'heap' ADT that is implemented with an
@@ -13,8 +15,9 @@
 // Note: The most extreme element should be found at the end of the
 // 'data' container, such that traversing the iterators yields the elements in
 // sorted order.
-template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class SortedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR>
+// STATS is the stats policy; see PQStats.h.
+template <typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename STATS = NoStats>
+class SortedPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS>
 {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
@@ -34,8 +37,9 @@ public:
     SortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR())
         : BaseClass{comp}, data{start, end}
     {
-        updatePriorities();
-
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(data.size());
+        std::sort(data.begin(), data.end(), counted());
     } // SortedPQ
 
     // Description: Destructor doesn't need any code, the data vector will
@@ -49,11 +53,60 @@ public:
 
     virtual void push(const TYPE &val)
     {
-
-        auto it = std::upper_bound(data.begin(), data.end(), val, this->compare);
+        this->counters().begin(PQOp::Push);
+        auto it = std::upper_bound(data.begin(), data.end(), val, counted());
+        this->counters().moved(static_cast<std::size_t>(data.end() - it) + 1);
         data.insert(it, val);
     } // push()
 
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: O(n)
+    virtual void push(TYPE &&val)
+    {
+        this->counters().begin(PQOp::Push);
+        auto it = std::upper_bound(data.begin(), data.end(), val, counted());
+        this->counters().moved(static_cast<std::size_t>(data.end() - it) + 1);
+        data.insert(it, std::move(val));
+    } // push()
+
+    // Description: Add every element of the range [first, last) to the heap by
+    //              sorting the new batch on its own and merging it into place,
+    //              rather than inserting the elements one at a time.
+    // Runtime: O(m log m + n) where m is number of elements in range.
+    template <typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last)
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::size_t old = data.size();
+        data.insert(data.end(), first, last);
+        this->counters().moved(data.size() - old);
+        std::sort(data.begin() + old, data.end(), counted());
+        std::inplace_merge(data.begin(), data.begin() + old, data.end(), counted());
+    } // pushRange()
+
+    // Description: Move every element of 'other' into this heap, leaving
+    //              'other' empty.  Both are already sorted, so they are
+    //              combined with a single linear merge.
+    // Runtime: O(n + m) where m is other.size().
+    void merge(SortedPQ &&other)
+    {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        if (data.empty())
+            data.swap(other.data);
+        else
+        {
+            std::size_t old = data.size();
+            this->counters().moved(other.data.size());
+            data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                        std::make_move_iterator(other.data.end()));
+            std::inplace_merge(data.begin(), data.begin() + old, data.end(), counted());
+        }
+        other.data.clear();
+    } // merge()
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the heap.
     // Note: We will not run tests on your code that would require it to pop an
@@ -62,9 +115,49 @@ public:
     // Runtime: Amortized O(1)
     virtual void pop()
     {
+        this->counters().begin(PQOp::Pop);
         data.pop_back();
     } // pop()
 
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: Amortized O(1)
+    virtual TYPE popTop()
+    {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+        TYPE val = std::move(data.back());
+        data.pop_back();
+        return val;
+    } // popTop()
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  'data' is in that order already, so this is one
+    //              pass of moves.  Returns the output iterator past the last
+    //              element written.
+    // Runtime: O(n)
+    template <typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out)
+    {
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(data.size());
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        return out;
+    } // drainSorted()
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them, by handing over 'data'.
+    // Runtime: O(1)
+    std::vector<TYPE> extractSorted() &&
+    {
+        this->counters().begin(PQOp::Bulk);
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        return sorted;
+    } // extractSorted()
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the vector.  This should be a reference for speed.  It MUST
     //              be const because we cannot allow it to be modified, as that
@@ -72,6 +165,7 @@ public:
     // Runtime: O(1)
     virtual const TYPE &top() const
     {
+        this->counters().begin(PQOp::Top);
         return data.back();
     } // top()
 
@@ -91,12 +185,68 @@ public:
         return data.empty();
     } // empty()
 
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const
+    {
+        return this->counters();
+    } // stats()
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats()
+    {
+        this->counters().reset();
+    } // resetStats()
+
     // Description: Assumes that all elements inside the heap are out of order and
     //              'rebuilds' the heap by fixing the heap invariant.
     // Runtime: O(n log n)
     virtual void updatePriorities()
     {
-        std::sort(data.begin(), data.end(), this->compare);
+        this->counters().begin(PQOp::Update);
+        std::sort(data.begin(), data.end(), counted());
+    } // updatePriorities()
+
+    // Description: Restore the order after the priorities of the elements for
+    //              which 'changed' returns true have changed in place.  Those
+    //              elements are moved to the back, sorted on their own and
+    //              merged into the rest, which is still in order.  When more
+    //              than half of them changed, everything is sorted instead.
+    // Runtime: O(n + k log k) where k is the number of changed elements.
+    template <typename Predicate>
+    void updatePriorities(Predicate changed)
+    {
+        this->counters().begin(PQOp::Update);
+        std::vector<TYPE> moved;
+        auto keep = data.begin();
+        for (auto it = data.begin(); it != data.end(); ++it)
+        {
+            if (changed(*it))
+                moved.push_back(std::move(*it));
+            else
+            {
+                if (keep != it)
+                {
+                    *keep = std::move(*it);
+                    this->counters().moved();
+                }
+                ++keep;
+            }
+        }
+        if (moved.empty())
+            return;
+
+        this->counters().moved(2 * moved.size());
+        std::move(moved.begin(), moved.end(), keep);
+        if (2 * moved.size() > data.size())
+            std::sort(data.begin(), data.end(), counted());
+        else
+        {
+            std::sort(keep, data.end(), counted());
+            std::inplace_merge(data.begin(), keep, data.end(), counted());
+        }
     } // updatePriorities()
 
 private:
@@ -105,6 +255,13 @@ private:
 
     // TODO: Add any additional member functions or data you require here.
 
+    // this->compare, reported to the stats policy, in a form the standard
+    // algorithms can take.
+    typename PQStatsCompare<COMP_FUNCTOR, STATS>::type counted() const
+    {
+        return PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters());
+    }
+
 }; // SortedPQ
 
 #endif // SORTEDPQ_H
@@ -4,6 +4,10 @@
 #define UNORDEREDFASTPQ_H
 
 #include "Eecs281PQ.h"
+#include "ExtremeScan.h"
+#include "PQStats.h"
+#include <algorithm>
+#include <iterator>
 
 #include <limits>  // needed for UNKNOWN
 
@@ -22,8 +26,9 @@ static const size_t UNKNOWN = std::numeric_limits<size_t>::max();
 // Pay particular attention to how the constructors and findExtreme()
 // are written, especially the use of this->compare.
 
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class UnorderedFastPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+// STATS is the stats policy; see PQStats.h.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename STATS = NoStats>
+class UnorderedFastPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>, private PQStatsHolder<STATS> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
@@ -41,6 +46,8 @@ public:
     template<typename InputIterator>
     UnorderedFastPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
         BaseClass{ comp }, data{ start, end }, extreme{ UNKNOWN } {
+        this->counters().begin(PQOp::Bulk);
+        this->counters().moved(data.size());
     } // UnorderedFastPQ()
 
 
@@ -54,6 +61,17 @@ public:
     //              most extreme element.
     // Runtime: O(1)
     virtual void updatePriorities() {
+        this->counters().begin(PQOp::Update);
+        extreme = UNKNOWN;
+    } // updatePriorities()
+
+
+    // Description: Same as updatePriorities(); which elements changed does
+    //              not matter when the next top() rescans anyway.
+    // Runtime: O(1)
+    template<typename Predicate>
+    void updatePriorities(Predicate) {
+        this->counters().begin(PQOp::Update);
         extreme = UNKNOWN;
     } // updatePriorities()
 
@@ -61,6 +79,8 @@ public:
     // Description: Add a new element to the heap.
     // Runtime: Amortized O(1)
     virtual void push(const TYPE &val) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
         data.push_back(val);
 
         // Since a new element has been added, we no longer know where to find
@@ -69,6 +89,60 @@ public:
     } // push()
 
 
+    // Description: Add a new element to the heap, moving from 'val'.
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.push_back(std::move(val));
+        extreme = UNKNOWN;
+    } // push()
+
+
+    // Description: Construct a new element in place at the back of the heap.
+    // Runtime: Amortized O(1)
+    template<typename... Args>
+    void emplace(Args &&... args) {
+        this->counters().begin(PQOp::Push);
+        this->counters().moved();
+        data.emplace_back(std::forward<Args>(args)...);
+        extreme = UNKNOWN;
+    } // emplace()
+
+
+    // Description: Add every element of the range [first, last) to the heap.
+    // Runtime: O(m) where m is number of elements in range.
+    template<typename InputIterator>
+    void pushRange(InputIterator first, InputIterator last) {
+        this->counters().begin(PQOp::Bulk);
+        size_t old = data.size();
+        data.insert(data.end(), first, last);
+        this->counters().moved(data.size() - old);
+        extreme = UNKNOWN;
+    } // pushRange()
+
+
+    // Description: Move every element of 'other' into this heap, leaving
+    //              'other' empty.
+    // Runtime: O(m) where m is other.size(), or O(1) if this heap is empty.
+    void merge(UnorderedFastPQ &&other) {
+        if (&other == this)
+            return;
+
+        this->counters().begin(PQOp::Bulk);
+        if (data.empty())
+            data.swap(other.data);
+        else {
+            this->counters().moved(other.data.size());
+            data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                        std::make_move_iterator(other.data.end()));
+        }
+        other.data.clear();
+        extreme = UNKNOWN;
+        other.extreme = UNKNOWN;
+    } // merge()
+
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the heap.
     // Note: We will not run tests on your code that would require it to pop an
@@ -78,6 +152,9 @@ public:
     // Note: If the most extreme element is already known (as would happen if
     //       .top() was called before .pop()), this function is O(1).
     virtual void pop() {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved();
+
         // If we don't already know the index of the most extreme element, find it.
         if (extreme == UNKNOWN)
             findExtreme();
@@ -85,7 +162,7 @@ public:
         // Replace the most extreme element with the element at the back, then
         // pop_back().  This is much faster than erasing from the middle of a
         // vector.
-        data[extreme] = data.back();
+        data[extreme] = std::move(data.back());
         data.pop_back();
 
         // Since the most extreme element has been removed, we no longer know
@@ -94,18 +171,69 @@ public:
     } // pop()
 
 
+    // Description: Remove the most extreme element from the heap and return
+    //              it, moving it out instead of copying it.
+    // Runtime: O(n)
+    // Note: If the most extreme element is already known, this function is O(1).
+    virtual TYPE popTop() {
+        this->counters().begin(PQOp::Pop);
+        this->counters().moved(2);
+        if (extreme == UNKNOWN)
+            findExtreme();
+
+        TYPE val = std::move(data[extreme]);
+        data[extreme] = std::move(data.back());
+        data.pop_back();
+        extreme = UNKNOWN;
+        return val;
+    } // popTop()
+
+
+    // Description: Empty the heap into 'out' in sorted order, ascending as
+    //              defined by 'compare', so the most extreme element comes
+    //              last.  'data' is sorted in place and moved out in one
+    //              pass.  Returns the output iterator past the last element
+    //              written.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drainSorted(OutputIterator out) {
+        this->counters().begin(PQOp::Bulk);
+        sortData();
+        this->counters().moved(data.size());
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        extreme = UNKNOWN;
+        return out;
+    } // drainSorted()
+
+
+    // Description: Empty the heap and return its elements in the order
+    //              drainSorted() writes them, by sorting 'data' in place and
+    //              handing it over.
+    // Runtime: O(n log(n))
+    std::vector<TYPE> extractSorted() && {
+        this->counters().begin(PQOp::Bulk);
+        sortData();
+        std::vector<TYPE> sorted;
+        sorted.swap(data);
+        extreme = UNKNOWN;
+        return sorted;
+    } // extractSorted()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the vector.  This should be a reference for speed.  It MUST
     //              be const because we cannot allow it to be modified, as that
     //              might make it no longer be the most extreme element.
     // Runtime: O(n)
     virtual const TYPE &top() const {
+        this->counters().begin(PQOp::Top);
         // If we don't already know the index of the most extreme element, find it.
         if (extreme == UNKNOWN)
             findExtreme();
 
         // Return the most extreme element by const reference.
-        return data[extreme];
+        return elementAt(data, extreme);
     } // top()
 
 
@@ -122,6 +250,21 @@ public:
     } // empty()
 
 
+    // Description: Return the stats policy, holding whatever it has recorded
+    //              so far; see PQStats.h.
+    // Runtime: O(1)
+    const STATS &stats() const {
+        return this->counters();
+    } // stats()
+
+
+    // Description: Clear everything the stats policy has recorded.
+    // Runtime: O(1)
+    void resetStats() {
+        this->counters().reset();
+    } // resetStats()
+
+
 private:
     // Note: This vector *must* be used your heap implementation.
     std::vector<TYPE> data;
@@ -133,17 +276,22 @@ private:
 
     // Description: Find the 'most extreme' element of the data vector, using
     //              this->compare() to check if one element is 'less than'
-    //              another.
+    //              another.  Arithmetic keys under std::less or std::greater
+    //              take a vectorized path; see ExtremeScan.h, though not
+    //              when the stats policy is counting comparisons.
     // Runtime: O(n)
     void findExtreme() const {
-        size_t index = 0;
+        this->counters().scanned(data.size());
+        extreme = extremeIndex(data, 0, data.size(),
+                               PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+    } // findExtreme()
 
-        for (size_t i = 1; i < data.size(); ++i)
-            if (this->compare(data[index], data[i]))
-                index = i;
 
-        extreme = index;
-    } // findExtreme()
+    // Description: Sort the data vector in ascending order by 'compare'.
+    // Runtime: O(n log(n))
+    void sortData() {
+        std::sort(data.begin(), data.end(), PQStatsCompare<COMP_FUNCTOR, STATS>::wrap(this->compare, this->counters()));
+    } // sortData()
 }; // UnorderedFastPQ
 
 #endif // UNORDEREDFASTPQ_H
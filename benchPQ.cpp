@@ -0,0 +1,2412 @@
+// Project identifier: AD48FB4835AF347EB0CA8009E24C3B13F8519882
+
+/*
+ * Non-interactive benchmarks for the priority queue implementations.
+ *
+ * Build with 'make bench' (release flags), then run
+ *     ./benchPQ [suite] [--max-n=N] [--quadratic-max-n=N] [--format=csv|json]
+ * where 'suite' is one of the names listed by './benchPQ help'.  With no
+ * argument every suite is run.  Results are printed one row per
+ * measurement so they can be compared between revisions.
+ *
+ * The 'workloads' suite sweeps every implementation over sizes from 1e2 up
+ * to --max-n (default 1e7) and prints CSV or JSON with ns/op, latency
+ * percentiles and peak resident set size, for regression tracking.  The
+ * O(n)-per-operation queues stop at --quadratic-max-n (default 1e4).
+ * Percentiles come from individually timed operations, each less the
+ * median cost of timing an empty region; that overhead is printed with the
+ * results as clock_overhead_ns.
+ *
+ * Files named bench*.cpp are never added to the submission tarballs.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "Eecs281PQ.h"
+#include "BinaryPQ.h"
+#include "BoundedPQ.h"
+#include "ExternalPQ.h"
+#include "ExtremeScan.h"
+#include "IndexedBinaryPQ.h"
+#include "KeyedBinaryPQ.h"
+#include "MultiQueue.h"
+#include "PairingPQ.h"
+#include "PQStats.h"
+#include "RadixPQ.h"
+#include "RankPairingPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "BlockedUnorderedPQ.h"
+#include "UnorderedPQ.h"
+
+using namespace std;
+
+// Every heap allocation made by the benchmarks goes through these, so the
+// suites can report allocations per operation.  The count is per thread, so
+// the multithreaded suites do not race on it; only the main thread reads it.
+static thread_local size_t allocationCount = 0;
+
+void *operator new(size_t size)
+{
+    ++allocationCount;
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+
+// GCC sees through the replacement operator new once it is inlined and
+// then reports the matching free() below as a mismatched deallocation.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Wall-clock stopwatch in nanoseconds.
+class Timer
+{
+public:
+    Timer() : start{chrono::steady_clock::now()} {}
+
+    double elapsedNs() const
+    {
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    chrono::steady_clock::time_point start;
+}; // Timer
+
+// Command line options shared by the suites.
+struct BenchOptions
+{
+    size_t maxN = 10000000;
+    size_t quadraticMaxN = 10000;
+    string format = "csv";
+}; // BenchOptions
+
+BenchOptions options;
+
+// Counts the last-level cache misses of this thread between construction
+// and misses(), through perf_event_open(2).  Where the kernel or the
+// machine does not provide the counter, available() is false.
+class MissCounter
+{
+public:
+    MissCounter() : fd{-1}
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~MissCounter()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    MissCounter(const MissCounter &) = delete;
+    MissCounter &operator=(const MissCounter &) = delete;
+
+    bool available() const
+    {
+        return fd >= 0;
+    }
+
+    uint64_t misses() const
+    {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (fd >= 0 && read(fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+            count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd;
+}; // MissCounter
+
+// A heavy payload that counts how often it is deep-copied or moved.
+struct CountedString
+{
+    static size_t copies;
+    static size_t moves;
+
+    string s;
+
+    CountedString() {}
+    explicit CountedString(string str) : s{std::move(str)} {}
+    CountedString(size_t len, char c) : s(len, c) {}
+    CountedString(const CountedString &other) : s{other.s} { ++copies; }
+    CountedString(CountedString &&other) noexcept : s{std::move(other.s)} { ++moves; }
+    CountedString &operator=(const CountedString &other)
+    {
+        s = other.s;
+        ++copies;
+        return *this;
+    }
+    CountedString &operator=(CountedString &&other) noexcept
+    {
+        s = std::move(other.s);
+        ++moves;
+        return *this;
+    }
+
+    static void resetCounts() { copies = moves = 0; }
+}; // CountedString
+
+size_t CountedString::copies = 0;
+size_t CountedString::moves = 0;
+
+struct CountedStringComp
+{
+    bool operator()(const CountedString &a, const CountedString &b) const
+    {
+        return a.s < b.s;
+    }
+};
+
+// Wraps another comparator and counts how often it is called.
+template <typename TYPE, typename COMP>
+struct CountingComp
+{
+    static size_t calls;
+
+    bool operator()(const TYPE &a, const TYPE &b) const
+    {
+        ++calls;
+        return COMP()(a, b);
+    }
+};
+
+template <typename TYPE, typename COMP>
+size_t CountingComp<TYPE, COMP>::calls = 0;
+
+vector<CountedString> randomStrings(size_t n, size_t len, unsigned seed)
+{
+    mt19937 gen(seed);
+    uniform_int_distribution<int> letter('a', 'z');
+    vector<CountedString> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        string s(len, ' ');
+        for (char &c : s)
+            c = static_cast<char>(letter(gen));
+        out.emplace_back(std::move(s));
+    }
+    return out;
+} // randomStrings()
+
+// Push n strings and drain the queue, either by copying in and out through
+// push(const TYPE &) / top(), or by moving through push(TYPE &&) / popTop().
+void copiesCase(const string &name, Eecs281PQ<CountedString, CountedStringComp> *pq, size_t n)
+{
+    for (bool moving : {false, true})
+    {
+        vector<CountedString> input = randomStrings(n, 64, 281);
+        CountedString::resetCounts();
+        Timer timer;
+        for (CountedString &s : input)
+        {
+            if (moving)
+                pq->push(std::move(s));
+            else
+                pq->push(s);
+        } // for
+        size_t checksum = 0;
+        while (!pq->empty())
+        {
+            if (moving)
+            {
+                CountedString s = pq->popTop();
+                checksum += s.s.size();
+            }
+            else
+            {
+                CountedString s = pq->top();
+                pq->pop();
+                checksum += s.s.size();
+            }
+        } // while
+        double ns = timer.elapsedNs();
+        double ops = 2.0 * static_cast<double>(n);
+        cout << left << setw(16) << name << setw(8) << (moving ? "move" : "copy")
+             << right << setw(10) << n
+             << setw(14) << fixed << setprecision(2) << static_cast<double>(CountedString::copies) / ops
+             << setw(14) << static_cast<double>(CountedString::moves) / ops
+             << setw(12) << setprecision(1) << ns / ops
+             << (checksum == n * 64 ? "" : "  CHECKSUM MISMATCH") << '\n';
+    } // for
+    delete pq;
+} // copiesCase()
+
+// Copy and move counts per operation for 64-character string payloads.
+void benchCopies()
+{
+    cout << "# suite: copies (per push/pop operation, 64-char strings)\n";
+    cout << left << setw(16) << "pq" << setw(8) << "mode" << right << setw(10) << "n"
+         << setw(14) << "copies/op" << setw(14) << "moves/op" << setw(12) << "ns/op" << '\n';
+    const size_t n = min<size_t>(20000, options.maxN);
+    const size_t quadraticN = min(n / 10, options.quadraticMaxN);
+    copiesCase("Unordered", new UnorderedPQ<CountedString, CountedStringComp>, quadraticN);
+    copiesCase("UnorderedFast", new UnorderedFastPQ<CountedString, CountedStringComp>, quadraticN);
+    copiesCase("Sorted", new SortedPQ<CountedString, CountedStringComp>, quadraticN);
+    copiesCase("Binary", new BinaryPQ<CountedString, CountedStringComp>, n);
+    copiesCase("Pairing", new PairingPQ<CountedString, CountedStringComp>, n);
+} // benchCopies()
+
+// Print one row of the alloc suite.
+void allocRow(const string &phase, size_t n, size_t ops, size_t allocs, double ns)
+{
+    cout << left << setw(12) << phase << right << setw(10) << n
+         << setw(14) << fixed << setprecision(3)
+         << static_cast<double>(allocs) / static_cast<double>(ops)
+         << setw(12) << setprecision(1) << ns / static_cast<double>(ops) << '\n';
+} // allocRow()
+
+// Heap allocations and time per operation for PairingPQ<int>: n pushes,
+// n steady-state pop+push pairs, then a full drain.
+void benchAlloc()
+{
+    cout << "# suite: alloc (PairingPQ<int>)\n";
+    cout << left << setw(12) << "phase" << right << setw(10) << "n"
+         << setw(14) << "allocs/op" << setw(12) << "ns/op" << '\n';
+    for (size_t n : {10000, 100000, 1000000})
+    {
+        if (n > options.maxN)
+            break;
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 30);
+        PairingPQ<int> pq;
+
+        size_t before = allocationCount;
+        Timer fill;
+        for (size_t i = 0; i < n; ++i)
+            pq.push(key(gen));
+        allocRow("push", n, n, allocationCount - before, fill.elapsedNs());
+
+        before = allocationCount;
+        Timer steady;
+        for (size_t i = 0; i < n; ++i)
+        {
+            int top = pq.top();
+            pq.pop();
+            pq.push(top - key(gen) % 1024);
+        } // for
+        allocRow("pop+push", n, 2 * n, allocationCount - before, steady.elapsedNs());
+
+        before = allocationCount;
+        Timer drain;
+        while (!pq.empty())
+            pq.pop();
+        allocRow("drain", n, n, allocationCount - before, drain.elapsedNs());
+    } // for
+} // benchAlloc()
+
+// Time n pushes interleaved with n / 4 pops (push-heavy), then a full
+// drain (pop-heavy), for a d-ary heap of int keys.
+template <size_t ARITY>
+void daryRow(size_t n)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    DaryPQ<int, std::less<int>, ARITY> pq;
+
+    Timer pushes;
+    size_t ops = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        pq.push(key(gen));
+        ++ops;
+        if (i % 4 == 3)
+        {
+            pq.pop();
+            ++ops;
+        } // if
+    } // for
+    double pushNs = pushes.elapsedNs() / static_cast<double>(ops);
+
+    size_t remaining = pq.size();
+    Timer pops;
+    while (!pq.empty())
+        pq.pop();
+    double popNs = pops.elapsedNs() / static_cast<double>(remaining);
+
+    cout << setw(6) << ARITY << setw(10) << n << fixed << setprecision(1)
+         << setw(14) << pushNs << setw(14) << popNs << '\n';
+} // daryRow()
+
+// Compare heap arities 2, 4 and 8.
+void benchDary()
+{
+    cout << "# suite: dary (DaryPQ<int>, ns/op)\n";
+    cout << setw(6) << "D" << setw(10) << "n" << setw(14) << "push-heavy" << setw(14) << "pop-heavy" << '\n';
+    for (size_t n : {100000, 1000000, 4000000})
+    {
+        daryRow<2>(n);
+        daryRow<4>(n);
+        daryRow<8>(n);
+    } // for
+} // benchDary()
+
+// Print one row of the sift suite; negative counts were not measured.
+void siftRow(const string &type, const string &phase, size_t n, double compares,
+             double moves, double copies, double ns)
+{
+    cout << left << setw(8) << type << setw(7) << phase << right << setw(10) << n
+         << fixed << setprecision(2) << setw(12) << compares;
+    if (moves < 0)
+        cout << setw(10) << "-" << setw(10) << "-";
+    else
+        cout << setw(10) << moves << setw(10) << copies;
+    cout << setw(10) << setprecision(1) << ns << '\n';
+} // siftRow()
+
+// Comparisons, element moves and time per push and per pop for BinaryPQ,
+// with int keys and with 64-character string payloads.
+void benchSift()
+{
+    cout << "# suite: sift (BinaryPQ, n pushes then n pops, per operation)\n";
+    cout << left << setw(8) << "type" << setw(7) << "phase" << right << setw(10) << "n"
+         << setw(12) << "compares" << setw(10) << "moves" << setw(10) << "copies"
+         << setw(10) << "ns" << '\n';
+    for (size_t n : {10000, 1000000})
+    {
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 30);
+        vector<int> keys(n);
+        for (int &k : keys)
+            k = key(gen);
+        double count = static_cast<double>(n);
+
+        using IntCount = CountingComp<int, std::less<int>>;
+        BinaryPQ<int, IntCount> counted;
+        IntCount::calls = 0;
+        for (int k : keys)
+            counted.push(k);
+        double pushCompares = static_cast<double>(IntCount::calls) / count;
+        IntCount::calls = 0;
+        while (!counted.empty())
+            counted.pop();
+        double popCompares = static_cast<double>(IntCount::calls) / count;
+
+        BinaryPQ<int> timed;
+        Timer pushes;
+        for (int k : keys)
+            timed.push(k);
+        siftRow("int", "push", n, pushCompares, -1, -1, pushes.elapsedNs() / count);
+        Timer pops;
+        while (!timed.empty())
+            timed.pop();
+        siftRow("int", "pop", n, popCompares, -1, -1, pops.elapsedNs() / count);
+
+        size_t heavyN = n / 10;
+        double heavyCount = static_cast<double>(heavyN);
+        using StringCount = CountingComp<CountedString, CountedStringComp>;
+        vector<CountedString> input = randomStrings(heavyN, 64, 281);
+        BinaryPQ<CountedString, StringCount> heavy;
+        heavy.push(CountedString(64, 'a'));
+        heavy.pop();
+        CountedString::resetCounts();
+        StringCount::calls = 0;
+        Timer heavyPushes;
+        for (CountedString &s : input)
+            heavy.push(std::move(s));
+        double heavyPushNs = heavyPushes.elapsedNs() / heavyCount;
+        siftRow("string", "push", heavyN, static_cast<double>(StringCount::calls) / heavyCount,
+                static_cast<double>(CountedString::moves) / heavyCount,
+                static_cast<double>(CountedString::copies) / heavyCount, heavyPushNs);
+        CountedString::resetCounts();
+        StringCount::calls = 0;
+        Timer heavyPops;
+        while (!heavy.empty())
+            heavy.pop();
+        double heavyPopNs = heavyPops.elapsedNs() / heavyCount;
+        siftRow("string", "pop", heavyN, static_cast<double>(StringCount::calls) / heavyCount,
+                static_cast<double>(CountedString::moves) / heavyCount,
+                static_cast<double>(CountedString::copies) / heavyCount, heavyPopNs);
+    } // for
+} // benchSift()
+
+// Time adding m elements to a queue that already holds n, one push() at a
+// time and through pushRange(), in ns per added element, plus the first
+// pop() afterwards, which pays for any work the insertion deferred.  Small
+// batches are repeated on fresh queues so each row covers at least 1e5
+// elements.
+template <typename PQ>
+void bulkRow(const string &name, size_t n, size_t m)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    vector<int> base(n), batch(m);
+    for (int &k : base)
+        k = key(gen);
+    for (int &k : batch)
+        k = key(gen);
+
+    size_t reps = max<size_t>(1, min<size_t>(20, 100000 / m));
+    double loopNs = 0;
+    double rangeNs = 0;
+    double loopPopNs = 0;
+    double rangePopNs = 0;
+    bool same = true;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        // Each queue is gone before the next is built, so neither run pays
+        // for page faults the other avoided.
+        int loopTop = 0;
+        int rangeTop = 0;
+        {
+            PQ looped;
+            looped.pushRange(base.begin(), base.end());
+            Timer loopTimer;
+            for (int k : batch)
+                looped.push(k);
+            loopNs += loopTimer.elapsedNs();
+            loopTop = looped.top();
+            Timer popTimer;
+            looped.pop();
+            loopPopNs += popTimer.elapsedNs();
+        }
+        {
+            PQ ranged;
+            ranged.pushRange(base.begin(), base.end());
+            Timer rangeTimer;
+            ranged.pushRange(batch.begin(), batch.end());
+            rangeNs += rangeTimer.elapsedNs();
+            rangeTop = ranged.top();
+            same = same && ranged.size() == n + m;
+            Timer popTimer;
+            ranged.pop();
+            rangePopNs += popTimer.elapsedNs();
+        }
+        same = same && loopTop == rangeTop;
+    } // for
+
+    double added = static_cast<double>(m * reps);
+    cout << left << setw(16) << name << right << setw(10) << n << setw(10) << m
+         << fixed << setprecision(1) << setw(12) << loopNs / added << setw(12) << rangeNs / added
+         << setw(14) << loopPopNs / static_cast<double>(reps)
+         << setw(14) << rangePopNs / static_cast<double>(reps) << (same ? "" : "  MISMATCH") << '\n';
+} // bulkRow()
+
+// push() in a loop against pushRange() across batch sizes.
+void benchBulk()
+{
+    cout << "# suite: bulk (ns per added element, then ns for the next pop)\n";
+    cout << left << setw(16) << "pq" << right << setw(10) << "n" << setw(10) << "m"
+         << setw(12) << "push loop" << setw(12) << "pushRange"
+         << setw(14) << "pop (loop)" << setw(14) << "pop (range)" << '\n';
+    for (size_t m : {100, 1000, 10000})
+    {
+        bulkRow<UnorderedPQ<int>>("Unordered", 10000, m);
+        bulkRow<UnorderedFastPQ<int>>("UnorderedFast", 10000, m);
+        bulkRow<SortedPQ<int>>("Sorted", 10000, m);
+    } // for
+    for (size_t m : {100, 10000, 100000, 1000000})
+    {
+        bulkRow<BinaryPQ<int>>("Binary", 100000, m);
+        bulkRow<DaryPQ<int>>("Dary4", 100000, m);
+        bulkRow<IndexedBinaryPQ<int>>("Indexed", 100000, m);
+        bulkRow<PairingPQ<int>>("Pairing", 100000, m);
+    } // for
+} // benchBulk()
+
+// A comparator the vectorized scan does not recognize, to time the generic
+// one on the same keys.
+template <typename TYPE, typename COMP>
+struct OpaqueComp
+{
+    bool operator()(const TYPE &a, const TYPE &b) const { return COMP()(a, b); }
+}; // OpaqueComp
+
+// Time extremeIndex() with and without the SIMD kernel over n random keys,
+// repeating the scan so every row covers about 1e8 elements.  One key is
+// rewritten between scans so the compiler cannot hoist the scan out.
+template <typename TYPE, typename COMP>
+void extremeRow(const string &type, size_t n)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(-(1 << 30), 1 << 30);
+    vector<TYPE> data(n);
+    for (TYPE &k : data)
+        k = static_cast<TYPE>(key(gen));
+    size_t reps = max<size_t>(1, 100000000 / n);
+    double elements = static_cast<double>(reps) * static_cast<double>(n);
+
+    size_t sink = 0;
+    Timer generic;
+    for (size_t r = 0; r < reps; ++r)
+    {
+        data[r % n] = static_cast<TYPE>(key(gen));
+        sink += extremeIndex(data.data(), n, OpaqueComp<TYPE, COMP>());
+    }
+    double genericNs = generic.elapsedNs() / elements;
+    Timer simd;
+    for (size_t r = 0; r < reps; ++r)
+    {
+        data[r % n] = static_cast<TYPE>(key(gen));
+        sink += extremeIndex(data.data(), n, COMP());
+    }
+    double simdNs = simd.elapsedNs() / elements;
+
+    cout << left << setw(8) << type << right << setw(10) << n << fixed << setprecision(3)
+         << setw(12) << genericNs << setw(12) << simdNs << setprecision(1)
+         << setw(10) << genericNs / simdNs << setw(4) << (sink % 2) << '\n';
+} // extremeRow()
+
+// The findExtreme() scan of the unordered queues: generic comparator loop
+// against the SIMD kernel used for arithmetic keys with std::less.
+void benchExtreme()
+{
+    cout << "# suite: extreme (extremeIndex, ns per element scanned; last column is a checksum)\n";
+    cout << left << setw(8) << "type" << right << setw(10) << "n" << setw(12) << "generic"
+         << setw(12) << "simd" << setw(10) << "speedup" << '\n';
+    for (size_t n : {1000, 10000, 100000, 1000000})
+    {
+        extremeRow<int32_t, std::less<int32_t>>("int32", n);
+        extremeRow<int64_t, std::less<int64_t>>("int64", n);
+        extremeRow<float, std::less<float>>("float", n);
+        extremeRow<double, std::less<double>>("double", n);
+    } // for
+} // benchExtreme()
+
+// Read one KB-valued field such as "VmRSS:" from /proc/self/status, or
+// return -1 where that file does not exist.
+long procStatusKb(const string &field)
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+        if (line.compare(0, field.size(), field) == 0)
+            return atol(line.c_str() + field.size());
+    return -1;
+} // procStatusKb()
+
+// Peak resident set size in KB since the last resetPeakRss().  Uses the
+// resettable VmHWM counter on Linux and falls back to the process-wide
+// maximum from getrusage() elsewhere.
+long peakRssKb()
+{
+    long hwm = procStatusKb("VmHWM:");
+    if (hwm >= 0)
+        return hwm;
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+} // peakRssKb()
+
+void resetPeakRss()
+{
+#ifdef __GLIBC__
+    // Hand memory freed by earlier runs back to the system first, so it is
+    // not silently reused and hidden from the next measurement.
+    malloc_trim(0);
+#endif
+    ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs)
+        clearRefs << "5";
+} // resetPeakRss()
+
+// Calls each measured operation without timing it individually.
+struct BulkProbe
+{
+    template <typename OP>
+    void operator()(OP op)
+    {
+        op();
+    }
+}; // BulkProbe
+
+// The median time Timer reports for an empty region: the cost of reading
+// the clock twice.  Measured once, on first use.
+double clockOverheadNs()
+{
+    static const double overhead = [] {
+        vector<double> samples(10001);
+        for (double &ns : samples)
+        {
+            Timer timer;
+            ns = timer.elapsedNs();
+        }
+        nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+    return overhead;
+} // clockOverheadNs()
+
+// Times every stride-th operation individually, for latency percentiles.
+// Each sample has clockOverheadNs() taken off, so that at small n, where an
+// operation costs about as much as reading the clock, the percentiles stay
+// comparable with the bulk ns/op.
+class SamplingProbe
+{
+public:
+    explicit SamplingProbe(size_t ops)
+        : stride{max<size_t>(1, ops / 10000)}, counter{0}, overhead{clockOverheadNs()}
+    {
+        samples.reserve(ops / stride + 1);
+    }
+
+    template <typename OP>
+    void operator()(OP op)
+    {
+        if (counter++ % stride != 0)
+        {
+            op();
+            return;
+        } // if
+        Timer timer;
+        op();
+        samples.push_back(max(0.0, timer.elapsedNs() - overhead));
+    }
+
+    void record(double ns) { samples.push_back(ns); }
+
+    // The p-th percentile (0 <= p <= 1) of the sampled latencies.
+    double percentile(double p)
+    {
+        if (samples.empty())
+            return 0;
+        sort(samples.begin(), samples.end());
+        size_t rank = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[rank];
+    }
+
+private:
+    size_t stride;
+    size_t counter;
+    double overhead;
+    vector<double> samples;
+}; // SamplingProbe
+
+// One row of the workloads suite.
+struct WorkloadResult
+{
+    string pq;
+    string workload;
+    size_t n;
+    size_t ops;
+    double nsPerOp;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+    long peakRssKb;
+    long rssGrowthKb;       // peak RSS minus RSS before the workload
+}; // WorkloadResult
+
+void printResult(const WorkloadResult &r, bool first)
+{
+    if (options.format == "json")
+    {
+        cout << (first ? "[\n" : ",\n") << fixed << setprecision(1)
+             << "  {\"pq\": \"" << r.pq << "\", \"workload\": \"" << r.workload
+             << "\", \"n\": " << r.n << ", \"ops\": " << r.ops
+             << ", \"ns_per_op\": " << r.nsPerOp << ", \"p50_ns\": " << r.p50
+             << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": " << r.p99
+             << ", \"max_ns\": " << r.max << ", \"clock_overhead_ns\": " << clockOverheadNs()
+             << ", \"peak_rss_kb\": " << r.peakRssKb << ", \"rss_growth_kb\": " << r.rssGrowthKb
+             << "}";
+    } // if
+    else
+    {
+        if (first)
+            cout << "# percentiles: sampled operations less clock_overhead_ns, the median\n"
+                    "# time of an empty timed region\n"
+                    "pq,workload,n,ops,ns_per_op,p50_ns,p90_ns,p99_ns,max_ns,"
+                    "clock_overhead_ns,peak_rss_kb,rss_growth_kb\n";
+        cout << fixed << setprecision(1) << r.pq << ',' << r.workload << ',' << r.n << ','
+             << r.ops << ',' << r.nsPerOp << ',' << r.p50 << ',' << r.p90 << ','
+             << r.p99 << ',' << r.max << ',' << clockOverheadNs() << ',' << r.peakRssKb << ','
+             << r.rssGrowthKb << '\n';
+    } // else
+    cout.flush();
+} // printResult()
+
+// Implementations covered by the workloads suite, and whether each one
+// costs O(n) per push or pop.
+const vector<pair<string, bool>> backends{
+    {"Unordered", true}, {"UnorderedFast", true}, {"Sorted", true},
+    {"Binary", false}, {"Dary4", false}, {"Indexed", false}, {"Pairing", false}};
+
+template <typename TYPE, typename COMP>
+Eecs281PQ<TYPE, COMP> *makePQ(const string &name)
+{
+    if (name == "Unordered")
+        return new UnorderedPQ<TYPE, COMP>;
+    if (name == "UnorderedFast")
+        return new UnorderedFastPQ<TYPE, COMP>;
+    if (name == "Sorted")
+        return new SortedPQ<TYPE, COMP>;
+    if (name == "Binary")
+        return new BinaryPQ<TYPE, COMP>;
+    if (name == "Dary4")
+        return new DaryPQ<TYPE, COMP, 4>;
+    if (name == "Indexed")
+        return new IndexedBinaryPQ<TYPE, COMP>;
+    return new PairingPQ<TYPE, COMP>;
+} // makePQ()
+
+// Run one workload, timing only its measured operations through 'probe',
+// and return how many operations were measured.  'input' holds 2n
+// elements, which are moved into the queue: the first n are pushed (or
+// pre-filled), the rest feed the pushes of the interleaved workloads.
+template <typename TYPE, typename COMP, typename PROBE>
+size_t runWorkload(const string &workload, Eecs281PQ<TYPE, COMP> &pq, vector<TYPE> &input,
+                   PROBE &probe)
+{
+    size_t n = input.size() / 2;
+    if (workload == "push" || workload == "heavy-push")
+    {
+        for (size_t i = 0; i < n; ++i)
+            probe([&] { pq.push(std::move(input[i])); });
+        return n;
+    } // if
+
+    for (size_t i = 0; i < n; ++i)
+        pq.push(std::move(input[i]));
+
+    if (workload == "drain" || workload == "heavy-drain")
+    {
+        for (size_t i = 0; i < n; ++i)
+            probe([&] { pq.pop(); });
+        return n;
+    } // if
+
+    // Interleaved "mixed-P:Q": P pushes for every Q pops, n operations.
+    size_t pushes = static_cast<size_t>(workload[6] - '0');
+    size_t pops = static_cast<size_t>(workload[8] - '0');
+    size_t next = n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i % (pushes + pops) < pushes)
+            probe([&] { pq.push(std::move(input[next++])); });
+        else
+            probe([&] { pq.pop(); });
+    } // for
+    return n;
+} // runWorkload()
+
+// Measure one workload twice on fresh queues: once in bulk for ns/op, once
+// sampling individual operations for latency percentiles.
+template <typename TYPE, typename COMP>
+WorkloadResult measureWorkload(const string &name, const string &workload, const vector<TYPE> &input)
+{
+    WorkloadResult r;
+    r.pq = name;
+    r.workload = workload;
+    r.n = input.size() / 2;
+
+    vector<TYPE> scratch(input);
+    resetPeakRss();
+    long baseline = procStatusKb("VmRSS:");
+    Eecs281PQ<TYPE, COMP> *pq = makePQ<TYPE, COMP>(name);
+    BulkProbe bulk;
+    Timer timer;
+    r.ops = runWorkload(workload, *pq, scratch, bulk);
+    r.nsPerOp = timer.elapsedNs() / static_cast<double>(r.ops);
+    r.peakRssKb = peakRssKb();
+    r.rssGrowthKb = baseline < 0 ? -1 : r.peakRssKb - baseline;
+    delete pq;
+
+    scratch = input;
+    pq = makePQ<TYPE, COMP>(name);
+    SamplingProbe sampler(r.ops);
+    runWorkload(workload, *pq, scratch, sampler);
+    r.p50 = sampler.percentile(0.50);
+    r.p90 = sampler.percentile(0.90);
+    r.p99 = sampler.percentile(0.99);
+    r.max = sampler.percentile(1.0);
+    delete pq;
+    return r;
+} // measureWorkload()
+
+struct IntPtrComp
+{
+    bool operator()(const int *a, const int *b) const
+    {
+        return *a < *b;
+    }
+};
+
+// Change every pointed-to key, then time updatePriorities(); ns/op is per
+// element per round.
+WorkloadResult measureUpdate(const string &name, size_t n)
+{
+    const size_t rounds = 3;
+    WorkloadResult r;
+    r.pq = name;
+    r.workload = "update";
+    r.n = n;
+    r.ops = n * rounds;
+
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    resetPeakRss();
+    long baseline = procStatusKb("VmRSS:");
+    vector<int> keys(n);
+    for (int &k : keys)
+        k = key(gen);
+    Eecs281PQ<int *, IntPtrComp> *pq = makePQ<int *, IntPtrComp>(name);
+    for (int &k : keys)
+        pq->push(&k);
+
+    SamplingProbe rounds_(rounds);
+    double total = 0;
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (int &k : keys)
+            k = key(gen);
+        Timer timer;
+        pq->updatePriorities();
+        double ns = timer.elapsedNs();
+        total += ns;
+        rounds_.record(ns / static_cast<double>(n));
+        if (*pq->top() != *max_element(keys.begin(), keys.end()))
+            cerr << name << " update: wrong top after updatePriorities()\n";
+    } // for
+    r.nsPerOp = total / static_cast<double>(r.ops);
+    r.p50 = rounds_.percentile(0.50);
+    r.p90 = rounds_.percentile(0.90);
+    r.p99 = rounds_.percentile(0.99);
+    r.max = rounds_.percentile(1.0);
+    r.peakRssKb = peakRssKb();
+    r.rssGrowthKb = baseline < 0 ? -1 : r.peakRssKb - baseline;
+    delete pq;
+    return r;
+} // measureUpdate()
+
+// Every implementation against every workload, for n = 1e2 .. --max-n.
+void benchWorkloads()
+{
+    const vector<string> intWorkloads{"push", "drain", "mixed-1:1", "mixed-3:1", "mixed-1:3"};
+    const vector<string> heavyWorkloads{"heavy-push", "heavy-drain"};
+    bool first = true;
+
+    for (size_t n = 100; n <= options.maxN; n *= 10)
+    {
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 30);
+        vector<int> ints(2 * n);
+        for (int &k : ints)
+            k = key(gen);
+
+        // 64-character strings; capped at 1e6 of them to keep memory sane.
+        vector<string> strings;
+        if (n <= 1000000)
+            for (const CountedString &s : randomStrings(2 * n, 64, 281))
+                strings.push_back(s.s);
+
+        for (const auto &backend : backends)
+        {
+            if (backend.second && n > options.quadraticMaxN)
+                continue;
+
+            for (const string &workload : intWorkloads)
+            {
+                printResult(measureWorkload<int, std::less<int>>(backend.first, workload, ints), first);
+                first = false;
+            } // for
+            printResult(measureUpdate(backend.first, n), first);
+            if (!strings.empty())
+                for (const string &workload : heavyWorkloads)
+                    printResult(measureWorkload<string, std::less<string>>(backend.first, workload, strings), first);
+        } // for
+    } // for
+
+    if (options.format == "json" && !first)
+        cout << "\n]\n";
+} // benchWorkloads()
+
+// The single-lock baseline for the multiqueue suite: one BinaryPQ behind one
+// mutex, with the same push/tryPop interface as MultiQueue.
+class LockedPQ
+{
+public:
+    void push(int val)
+    {
+        lock_guard<mutex> guard(lock);
+        heap.push(val);
+    } // push()
+
+    bool tryPop(int &out)
+    {
+        lock_guard<mutex> guard(lock);
+        if (heap.empty())
+            return false;
+        out = heap.popTop();
+        return true;
+    } // tryPop()
+
+private:
+    mutex lock;
+    BinaryPQ<int> heap;
+}; // LockedPQ
+
+// Prefill 'queue' with 'prefill' random keys, then let 'threads' threads
+// split 'ops' operations between them, alternating push and tryPop.
+// Returns millions of operations per second.
+template <typename QUEUE>
+double concurrentThroughput(QUEUE &queue, size_t threads, size_t prefill, size_t ops)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    for (size_t i = 0; i < prefill; ++i)
+        queue.push(key(gen));
+
+    vector<thread> workers;
+    Timer timer;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&queue, t, threads, ops]() {
+            mt19937 local(static_cast<unsigned>(t) + 1);
+            uniform_int_distribution<int> keys(0, 1 << 30);
+            int val;
+            for (size_t i = t; i < ops; i += threads)
+            {
+                if (i % 2 == 0)
+                    queue.push(keys(local));
+                else
+                    queue.tryPop(val);
+            }
+        });
+    for (thread &worker : workers)
+        worker.join();
+    return static_cast<double>(ops) / timer.elapsedNs() * 1e3;
+} // concurrentThroughput()
+
+// Fill a MultiQueue with the keys 0..n-1 and let 'threads' threads pop it
+// empty.  Every pop is stamped from a shared counter just after it returns;
+// replaying the pops in stamp order against a Fenwick tree of the keys
+// still present gives each pop's rank error, the number of larger keys that
+// were still in the queue (0 for an exact priority queue).
+pair<double, size_t> multiQueueRankError(size_t threads, size_t n)
+{
+    MultiQueue<int> queue(threads);
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = static_cast<int>(i);
+    shuffle(keys.begin(), keys.end(), mt19937(281));
+    for (int k : keys)
+        queue.push(k);
+
+    vector<pair<size_t, int>> pops(n);
+    atomic<size_t> stamp{0};
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&queue, &pops, &stamp]() {
+            int val;
+            while (queue.tryPop(val))
+                pops[stamp.fetch_add(1)] = {0, val};
+        });
+    for (thread &worker : workers)
+        worker.join();
+
+    // Fenwick tree over key presence, 1-based.
+    vector<size_t> tree(n + 1, 0);
+    for (size_t i = 1; i <= n; ++i)
+    {
+        tree[i] += 1;
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= n)
+            tree[parent] += tree[i];
+    }
+    auto present = [&tree](size_t upTo) {
+        size_t sum = 0;
+        for (size_t i = upTo; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    };
+
+    double total = 0;
+    size_t worst = 0, remaining = n;
+    for (const auto &entry : pops)
+    {
+        size_t k = static_cast<size_t>(entry.second);
+        size_t rank = remaining - present(k + 1);
+        total += static_cast<double>(rank);
+        worst = max(worst, rank);
+        for (size_t i = k + 1; i <= n; i += i & (~i + 1))
+            tree[i] -= 1;
+        --remaining;
+    }
+    return {total / static_cast<double>(n), worst};
+} // multiQueueRankError()
+
+// Throughput of MultiQueue against a single locked BinaryPQ, and the rank
+// error of MultiQueue pops, from 1 to 64 threads.  Throughput beyond the
+// machine's hardware threads only measures oversubscription.
+void benchMultiQueue()
+{
+    cout << "# suite: multiqueue (" << thread::hardware_concurrency()
+         << " hardware threads; Mops/s for 50% push / 50% pop on 1e6 elements)\n";
+    cout << setw(8) << "threads" << setw(8) << "shards" << setw(12) << "multi" << setw(12) << "locked"
+         << setw(12) << "mean-rank" << setw(10) << "max-rank" << '\n';
+    size_t prefill = min<size_t>(1000000, options.maxN);
+    for (size_t threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        MultiQueue<int> multi(threads);
+        double multiOps = concurrentThroughput(multi, threads, prefill, 4000000);
+        LockedPQ locked;
+        double lockedOps = concurrentThroughput(locked, threads, prefill, 4000000);
+        pair<double, size_t> rank = multiQueueRankError(threads, prefill);
+        cout << setw(8) << threads << setw(8) << multi.shardCount() << fixed << setprecision(2)
+             << setw(12) << multiOps << setw(12) << lockedOps << setprecision(1)
+             << setw(12) << rank.first << setw(10) << rank.second << '\n';
+    } // for
+} // benchMultiQueue()
+
+// Push n keys, then n rounds of top() + pop() + push(), then drain, through
+// 'pq'.  PQ is either a concrete queue, whose calls are bound statically
+// because every implementation is final, or Eecs281PQ<int>, whose calls are
+// virtual.  Returns ns per operation.
+template <typename PQ>
+double dispatchRun(PQ &pq, const vector<int> &keys, long long &sink)
+{
+    size_t n = keys.size() / 2;
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+        pq.push(keys[i]);
+    for (size_t i = n; i < 2 * n; ++i)
+    {
+        sink += pq.top();
+        pq.pop();
+        pq.push(keys[i]);
+    }
+    while (!pq.empty())
+    {
+        sink += pq.top();
+        pq.pop();
+    }
+    return timer.elapsedNs() / static_cast<double>(6 * n);
+} // dispatchRun()
+
+template <typename PQ>
+void dispatchRow(const string &name, size_t n)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    vector<int> keys(2 * n);
+    for (int &k : keys)
+        k = key(gen);
+
+    long long sink = 0;
+    double staticNs, virtualNs;
+    {
+        PQ pq;
+        staticNs = dispatchRun(pq, keys, sink);
+    }
+    {
+        // Chosen by name at run time, as testPQ does, so the compiler
+        // cannot know the dynamic type.
+        unique_ptr<Eecs281PQ<int>> pq(makePQ<int, std::less<int>>(name));
+        virtualNs = dispatchRun(*pq, keys, sink);
+    }
+    cout << left << setw(15) << name << right << setw(10) << n << fixed << setprecision(1)
+         << setw(10) << staticNs << setw(10) << virtualNs << setprecision(2)
+         << setw(10) << virtualNs / staticNs << setw(4) << (sink & 1) << '\n';
+} // dispatchRow()
+
+// The same int workload through the concrete (final) type and through an
+// Eecs281PQ pointer.
+void benchDispatch()
+{
+    cout << "# suite: dispatch (ns/op, push + top/pop/push + drain; last column is a checksum)\n";
+    cout << left << setw(15) << "pq" << right << setw(10) << "n" << setw(10) << "static"
+         << setw(10) << "virtual" << setw(10) << "ratio" << '\n';
+    for (size_t n : {1000, 100000, 1000000})
+    {
+        dispatchRow<BinaryPQ<int>>("Binary", n);
+        dispatchRow<DaryPQ<int, std::less<int>, 4>>("Dary4", n);
+        dispatchRow<PairingPQ<int>>("Pairing", n);
+        dispatchRow<IndexedBinaryPQ<int>>("Indexed", n);
+        if (n <= options.quadraticMaxN)
+        {
+            dispatchRow<SortedPQ<int>>("Sorted", n);
+            dispatchRow<UnorderedFastPQ<int>>("UnorderedFast", n);
+        }
+    } // for
+} // benchDispatch()
+
+// A random directed graph in compressed sparse row form.
+struct Graph
+{
+    vector<size_t> firstEdge;
+    vector<uint32_t> target;
+    vector<uint32_t> weight;
+}; // Graph
+
+Graph randomGraph(size_t n, size_t degree, uint32_t maxWeight)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<uint32_t> vertex(0, static_cast<uint32_t>(n - 1));
+    uniform_int_distribution<uint32_t> weight(1, maxWeight);
+    Graph g;
+    for (size_t v = 0; v < n; ++v)
+    {
+        g.firstEdge.push_back(g.target.size());
+        for (size_t e = 0; e < degree; ++e)
+        {
+            g.target.push_back(vertex(gen));
+            g.weight.push_back(weight(gen));
+        }
+    }
+    g.firstEdge.push_back(g.target.size());
+    return g;
+} // randomGraph()
+
+// Queue entries for Dijkstra: (tentative distance, vertex).
+using DistEntry = pair<uint64_t, uint32_t>;
+
+struct DistGreater
+{
+    bool operator()(const DistEntry &a, const DistEntry &b) const { return a.first > b.first; }
+}; // DistGreater
+
+struct DistKey
+{
+    uint64_t operator()(const DistEntry &e) const { return e.first; }
+}; // DistKey
+
+// Single-source shortest paths from vertex 0 with lazy deletion: a vertex is
+// pushed again whenever its distance improves, and stale entries are skipped
+// when popped.  Prints one row and returns the sum of reachable distances.
+template <typename PQ>
+uint64_t dijkstraRow(const string &name, const Graph &g, uint32_t maxWeight)
+{
+    size_t n = g.firstEdge.size() - 1;
+    vector<uint64_t> dist(n, UINT64_MAX);
+    PQ pq;
+    size_t pushes = 1, pops = 0;
+
+    Timer timer;
+    dist[0] = 0;
+    pq.push(DistEntry{0, 0});
+    while (!pq.empty())
+    {
+        DistEntry top = pq.popTop();
+        ++pops;
+        if (top.first != dist[top.second])
+            continue;
+        for (size_t e = g.firstEdge[top.second]; e < g.firstEdge[top.second + 1]; ++e)
+        {
+            uint64_t candidate = top.first + g.weight[e];
+            if (candidate < dist[g.target[e]])
+            {
+                dist[g.target[e]] = candidate;
+                pq.push(DistEntry{candidate, g.target[e]});
+                ++pushes;
+            }
+        }
+    }
+    double ns = timer.elapsedNs();
+
+    uint64_t checksum = 0;
+    for (uint64_t d : dist)
+        if (d != UINT64_MAX)
+            checksum += d;
+    cout << left << setw(8) << name << right << setw(10) << n << setw(12) << maxWeight
+         << setw(10) << pushes << setw(10) << pops << fixed << setprecision(1)
+         << setw(10) << ns / 1e6 << setw(12) << ns / static_cast<double>(pushes + pops)
+         << setw(22) << checksum << '\n';
+    return checksum;
+} // dijkstraRow()
+
+// Shortest paths on random graphs of average out-degree 8, with small and
+// large edge weights, comparing the radix heap with binary and 4-ary heaps.
+void benchDijkstra()
+{
+    cout << "# suite: dijkstra (lazy-deletion SSSP, ns per push or pop)\n";
+    cout << left << setw(8) << "pq" << right << setw(10) << "n" << setw(12) << "max-weight"
+         << setw(10) << "pushes" << setw(10) << "pops" << setw(10) << "ms"
+         << setw(12) << "ns/op" << setw(22) << "checksum" << '\n';
+    for (size_t n : {100000, 1000000})
+    {
+        if (n > options.maxN)
+            break;
+        for (uint32_t maxWeight : {100u, 1000000000u})
+        {
+            Graph g = randomGraph(n, 8, maxWeight);
+            uint64_t expected = dijkstraRow<BinaryPQ<DistEntry, DistGreater>>("Binary", g, maxWeight);
+            if (dijkstraRow<DaryPQ<DistEntry, DistGreater, 4>>("Dary4", g, maxWeight) != expected ||
+                dijkstraRow<RadixPQ<DistEntry, DistKey>>("Radix", g, maxWeight) != expected)
+                cout << "# error: distances differ\n";
+        } // for
+    } // for
+} // benchDijkstra()
+
+// Adding an element and lowering its key through a handle, for the queues
+// that hand them out.
+template <typename TYPE, typename COMP>
+typename PairingPQ<TYPE, COMP>::Node *addHandle(PairingPQ<TYPE, COMP> &pq, const TYPE &val)
+{
+    return pq.addNode(val);
+} // addHandle()
+
+template <typename TYPE, typename COMP>
+typename RankPairingPQ<TYPE, COMP>::Node *addHandle(RankPairingPQ<TYPE, COMP> &pq, const TYPE &val)
+{
+    return pq.addNode(val);
+} // addHandle()
+
+template <typename TYPE, typename COMP>
+typename IndexedBinaryPQ<TYPE, COMP>::Handle addHandle(IndexedBinaryPQ<TYPE, COMP> &pq, const TYPE &val)
+{
+    return pq.addElt(val);
+} // addHandle()
+
+template <typename TYPE, typename COMP>
+void improve(PairingPQ<TYPE, COMP> &pq, typename PairingPQ<TYPE, COMP>::Node *node, const TYPE &val)
+{
+    pq.updateElt(node, val);
+} // improve()
+
+template <typename TYPE, typename COMP>
+void improve(RankPairingPQ<TYPE, COMP> &pq, typename RankPairingPQ<TYPE, COMP>::Node *node,
+             const TYPE &val)
+{
+    pq.updateElt(node, val);
+} // improve()
+
+template <typename TYPE, typename COMP>
+void improve(IndexedBinaryPQ<TYPE, COMP> &pq, typename IndexedBinaryPQ<TYPE, COMP>::Handle handle,
+             const TYPE &val)
+{
+    pq.update(handle, val);
+} // improve()
+
+// A complete DAG on n vertices whose weights make every relaxation lower the
+// key of a vertex still queued: vertex k reaches j > k at distance
+// j + 2 (j - 1 - k), which falls as k grows, and the vertices are settled in
+// order 0, 1, 2, ... at distance j.
+Graph decreasingGraph(size_t n)
+{
+    Graph g;
+    for (size_t k = 0; k < n; ++k)
+    {
+        g.firstEdge.push_back(g.target.size());
+        for (size_t j = k + 1; j < n; ++j)
+        {
+            g.target.push_back(static_cast<uint32_t>(j));
+            g.weight.push_back(static_cast<uint32_t>(j - k + 2 * (j - 1 - k)));
+        }
+    }
+    g.firstEdge.push_back(g.target.size());
+    return g;
+} // decreasingGraph()
+
+// Single-source shortest paths from vertex 0 with decrease-key: each vertex
+// is added once, and its entry is updated in place through its handle
+// whenever its distance improves.  With 'queueAll', every vertex is added up
+// front at infinite distance, as in the textbook version, so even the first
+// improvement is a decrease-key.  Prints one row and returns the sum of
+// reachable distances.
+template <typename PQ>
+uint64_t decreaseKeyRow(const string &name, const Graph &g, size_t degree, bool queueAll)
+{
+    size_t n = g.firstEdge.size() - 1;
+    vector<uint64_t> dist(n, UINT64_MAX);
+    PQ pq;
+    using Handle = decltype(addHandle(pq, DistEntry{}));
+    vector<Handle> handles(n);
+    vector<bool> queued(n, false);
+    size_t decreases = 0;
+
+    Timer timer;
+    dist[0] = 0;
+    handles[0] = addHandle(pq, DistEntry{0, 0});
+    queued[0] = true;
+    if (queueAll)
+        for (uint32_t v = 1; v < n; ++v)
+        {
+            handles[v] = addHandle(pq, DistEntry{UINT64_MAX, v});
+            queued[v] = true;
+        }
+    while (!pq.empty())
+    {
+        DistEntry top = pq.popTop();
+        queued[top.second] = false;
+        if (top.first == UINT64_MAX)
+            continue;
+        for (size_t e = g.firstEdge[top.second]; e < g.firstEdge[top.second + 1]; ++e)
+        {
+            uint32_t v = g.target[e];
+            uint64_t candidate = top.first + g.weight[e];
+            if (candidate >= dist[v])
+                continue;
+            if (queued[v])
+            {
+                improve(pq, handles[v], DistEntry{candidate, v});
+                ++decreases;
+            }
+            else if (dist[v] == UINT64_MAX)
+            {
+                handles[v] = addHandle(pq, DistEntry{candidate, v});
+                queued[v] = true;
+            }
+            dist[v] = candidate;
+        }
+    }
+    double ns = timer.elapsedNs();
+
+    uint64_t checksum = 0;
+    for (uint64_t d : dist)
+        if (d != UINT64_MAX)
+            checksum += d;
+    cout << left << setw(12) << name << right << setw(8) << n << setw(8) << degree
+         << setw(12) << decreases << fixed << setprecision(1) << setw(10) << ns / 1e6
+         << setw(12) << ns / static_cast<double>(decreases) << setw(22) << checksum << '\n';
+    return checksum;
+} // decreaseKeyRow()
+
+// Add n entries with random keys, then n times move a random entry to the
+// front by lowering its key below every other, then pop everything.  Prints one row and returns a checksum of the pops.
+template <typename PQ>
+uint64_t boostRow(const string &name, size_t n)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<uint64_t> key(1000000, 2000000);
+    uniform_int_distribution<uint32_t> vertex(0, static_cast<uint32_t>(n - 1));
+    vector<uint64_t> dist(n);
+    for (uint64_t &d : dist)
+        d = key(gen);
+    vector<uint32_t> order(n);
+    for (uint32_t &v : order)
+        v = vertex(gen);
+
+    PQ pq;
+    using Handle = decltype(addHandle(pq, DistEntry{}));
+    vector<Handle> handles(n);
+    Timer timer;
+    for (uint32_t v = 0; v < n; ++v)
+        handles[v] = addHandle(pq, DistEntry{dist[v], v});
+    uint64_t front = 1000000;
+    for (uint32_t v : order)
+    {
+        dist[v] = --front;
+        improve(pq, handles[v], DistEntry{dist[v], v});
+    }
+    uint64_t checksum = 0;
+    for (uint64_t i = 1; !pq.empty(); ++i)
+        checksum += i * pq.popTop().first;
+    double ns = timer.elapsedNs();
+
+    cout << left << setw(12) << name << right << setw(8) << n << setw(8) << ""
+         << setw(12) << n << fixed << setprecision(1) << setw(10) << ns / 1e6
+         << setw(12) << ns / static_cast<double>(n) << setw(22) << checksum << '\n';
+    return checksum;
+} // boostRow()
+
+// Add n entries with random keys, then until the queue is empty, make
+// 'ratio' decrease-keys on random queued entries, each lowering the key by
+// up to a quarter, for every pop.  Every key is v modulo n for its vertex v,
+// so there are no ties and every queue pops in the same order.  Prints one
+// row and returns a checksum of the pops.
+template <typename PQ>
+uint64_t ratioRow(const string &name, size_t n, size_t ratio)
+{
+    mt19937 gen(281);
+    uniform_int_distribution<uint64_t> key(1000000000, 2000000000);
+    vector<uint64_t> dist(n);
+    for (size_t v = 0; v < n; ++v)
+        dist[v] = key(gen) * n + v;
+    vector<uint32_t> live(n);
+    vector<size_t> position(n);
+    for (uint32_t v = 0; v < n; ++v)
+        live[v] = v;
+    for (size_t v = 0; v < n; ++v)
+        position[v] = v;
+
+    PQ pq;
+    using Handle = decltype(addHandle(pq, DistEntry{}));
+    vector<Handle> handles(n);
+    size_t decreases = 0;
+    uint64_t checksum = 0;
+    Timer timer;
+    for (uint32_t v = 0; v < n; ++v)
+        handles[v] = addHandle(pq, DistEntry{dist[v], v});
+    for (uint64_t i = 1; !pq.empty(); ++i)
+    {
+        for (size_t k = 0; k < ratio; ++k)
+        {
+            uint32_t v = live[gen() % live.size()];
+            dist[v] -= n * (1 + gen() % (dist[v] / n / 4 + 1));
+            improve(pq, handles[v], DistEntry{dist[v], v});
+        }
+        decreases += ratio;
+        DistEntry top = pq.popTop();
+        checksum += i * top.first;
+        live[position[top.second]] = live.back();
+        position[live.back()] = position[top.second];
+        live.pop_back();
+    }
+    double ns = timer.elapsedNs();
+
+    cout << left << setw(12) << name << right << setw(8) << n << setw(8) << ratio
+         << setw(12) << decreases << fixed << setprecision(1) << setw(10) << ns / 1e6
+         << setw(12) << ns / static_cast<double>(n + decreases) << setw(22) << checksum << '\n';
+    return checksum;
+} // ratioRow()
+
+// Dijkstra on dense graphs with decrease-key: PairingPQ::updateElt() and
+// RankPairingPQ::updateElt() against IndexedBinaryPQ handles, adding each
+// vertex when first reached and, in the "+all" rows, adding every vertex up
+// front.  The random graphs have out-degree n / 4 and weights up to 1e9; on
+// the decreasingGraph() ones every relaxation is a decrease-key.  The next
+// rows move random entries of a heap that has only been pushed to to the
+// front.  ns/op is total time per decrease-key in both.  The last rows
+// sweep the number of decrease-keys per pop on random keys, and there
+// ns/op is total time per pop or decrease-key.
+void benchDecreaseKey()
+{
+    cout << "# suite: decreasekey (dense-graph SSSP with decrease-key)\n";
+    cout << left << setw(12) << "pq" << right << setw(8) << "n" << setw(8) << "degree"
+         << setw(12) << "decreases" << setw(10) << "ms" << setw(12) << "ns/op"
+         << setw(22) << "checksum" << '\n';
+    vector<pair<Graph, size_t>> graphs;
+    for (size_t n : {1000, 4000, 10000})
+        if (n <= options.maxN)
+            graphs.emplace_back(randomGraph(n, n / 4, 1000000000u), n / 4);
+    for (size_t n : {1000, 4000})
+        if (n <= options.maxN)
+            graphs.emplace_back(decreasingGraph(n), n - 1);
+
+    for (const auto &entry : graphs)
+    {
+        const Graph &g = entry.first;
+        size_t degree = entry.second;
+        using Pairing = PairingPQ<DistEntry, DistGreater>;
+        using Rank = RankPairingPQ<DistEntry, DistGreater>;
+        using Indexed = IndexedBinaryPQ<DistEntry, DistGreater>;
+        uint64_t expected = decreaseKeyRow<Pairing>("Pairing", g, degree, false);
+        if (decreaseKeyRow<Rank>("Rank", g, degree, false) != expected ||
+            decreaseKeyRow<Indexed>("Indexed", g, degree, false) != expected ||
+            decreaseKeyRow<Pairing>("Pairing+all", g, degree, true) != expected ||
+            decreaseKeyRow<Rank>("Rank+all", g, degree, true) != expected ||
+            decreaseKeyRow<Indexed>("Indexed+all", g, degree, true) != expected)
+            cout << "# error: distances differ\n";
+    } // for
+
+    // Without pops in between, every push leaves its node as a child of the
+    // root, so the root has thousands of children when the updates start.
+    cout << left << setw(12) << "pq" << right << setw(8) << "n" << setw(8) << ""
+         << setw(12) << "decreases" << setw(10) << "ms" << setw(12) << "ns/op"
+         << setw(22) << "checksum" << '\n';
+    for (size_t n : {10000, 30000})
+    {
+        if (n > options.maxN)
+            break;
+        uint64_t expected = boostRow<PairingPQ<DistEntry, DistGreater>>("Pairing", n);
+        if (boostRow<RankPairingPQ<DistEntry, DistGreater>>("Rank", n) != expected ||
+            boostRow<IndexedBinaryPQ<DistEntry, DistGreater>>("Indexed", n) != expected)
+            cout << "# error: pops differ\n";
+    } // for
+
+    cout << left << setw(12) << "pq" << right << setw(8) << "n" << setw(8) << "ratio"
+         << setw(12) << "decreases" << setw(10) << "ms" << setw(12) << "ns/op"
+         << setw(22) << "checksum" << '\n';
+    for (size_t n : {100000, 1000000})
+    {
+        if (n > options.maxN)
+            break;
+        for (size_t ratio : {0, 1, 4, 16, 64})
+        {
+            if (n * ratio > 20000000)
+                break;
+            uint64_t expected = ratioRow<PairingPQ<DistEntry, DistGreater>>("Pairing", n, ratio);
+            if (ratioRow<RankPairingPQ<DistEntry, DistGreater>>("Rank", n, ratio) != expected ||
+                ratioRow<IndexedBinaryPQ<DistEntry, DistGreater>>("Indexed", n, ratio) != expected)
+                cout << "# error: pops differ\n";
+        } // for
+    } // for
+} // benchDecreaseKey()
+
+// Wraps a vector iterator as a single-pass input iterator, so a range
+// constructor cannot measure the range ahead of time.
+template <typename TYPE>
+struct SinglePass
+{
+    using iterator_category = input_iterator_tag;
+    using value_type = TYPE;
+    using difference_type = ptrdiff_t;
+    using pointer = const TYPE *;
+    using reference = const TYPE &;
+
+    typename vector<TYPE>::const_iterator it;
+
+    reference operator*() const { return *it; }
+    SinglePass &operator++()
+    {
+        ++it;
+        return *this;
+    }
+    bool operator==(const SinglePass &other) const { return it == other.it; }
+    bool operator!=(const SinglePass &other) const { return it != other.it; }
+}; // SinglePass
+
+// Print one row of the build suite and check the heap by its first pop.
+template <typename PQ>
+void buildRow(const string &method, size_t n, PQ &pq, double ns, size_t compares, size_t allocs,
+              int expectedTop)
+{
+    Timer popTimer;
+    int top = pq.popTop();
+    double popNs = popTimer.elapsedNs();
+    double count = static_cast<double>(n);
+    cout << left << setw(14) << method << right << setw(10) << n << fixed << setprecision(2)
+         << setw(12) << ns / count << setw(12) << static_cast<double>(compares) / count
+         << setw(12) << static_cast<double>(allocs) / count << setprecision(1) << setw(14) << popNs
+         << (top == expectedTop ? "" : "  MISMATCH") << '\n';
+} // buildRow()
+
+// Building a PairingPQ<int> of n random keys: push() in a loop, against
+// the range constructor from a vector (whose size is known, so node
+// storage is reserved up front) and from a single-pass input iterator.
+void benchBuild()
+{
+    cout << "# suite: build (PairingPQ<int>, per element, then ns for the first pop)\n";
+    cout << left << setw(14) << "method" << right << setw(10) << "n" << setw(12) << "ns"
+         << setw(12) << "compares" << setw(12) << "allocs" << setw(14) << "first pop" << '\n';
+    using Comp = CountingComp<int, std::less<int>>;
+    for (size_t n : {100000, 1000000, 10000000})
+    {
+        if (n > options.maxN)
+            break;
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 30);
+        vector<int> keys(n);
+        for (int &k : keys)
+            k = key(gen);
+        int expectedTop = *max_element(keys.begin(), keys.end());
+
+        {
+            Comp::calls = 0;
+            size_t before = allocationCount;
+            Timer timer;
+            PairingPQ<int, Comp> pq;
+            for (int k : keys)
+                pq.push(k);
+            double ns = timer.elapsedNs();
+            buildRow("push loop", n, pq, ns, Comp::calls, allocationCount - before, expectedTop);
+        }
+        {
+            Comp::calls = 0;
+            size_t before = allocationCount;
+            Timer timer;
+            PairingPQ<int, Comp> pq(keys.begin(), keys.end());
+            double ns = timer.elapsedNs();
+            buildRow("range", n, pq, ns, Comp::calls, allocationCount - before, expectedTop);
+        }
+        {
+            Comp::calls = 0;
+            size_t before = allocationCount;
+            Timer timer;
+            PairingPQ<int, Comp> pq(SinglePass<int>{keys.begin()}, SinglePass<int>{keys.end()});
+            double ns = timer.elapsedNs();
+            buildRow("range (input)", n, pq, ns, Comp::calls, allocationCount - before, expectedTop);
+        }
+    } // for
+} // benchBuild()
+
+// Print one row of the topk suite.  'allocs' counts the allocations made
+// after the queue was constructed.
+void topkRow(const string &method, size_t n, size_t k, double ns, size_t allocs, size_t held,
+             long long checksum)
+{
+    cout << left << setw(16) << method << right << setw(10) << n << setw(8) << k << fixed
+         << setprecision(2) << setw(10) << ns / static_cast<double>(n) << setw(10) << allocs
+         << setw(12) << held << setw(22) << checksum << '\n';
+} // topkRow()
+
+// Keep the k largest of n random ints and write them out sorted: BoundedPQ
+// against a hand-rolled std::priority_queue of size k (pop, then push), and
+// against a BinaryPQ that holds the whole stream and is popped k times.
+// 'held' is the most elements each one stores; the checksums must agree.
+void benchTopK()
+{
+    cout << "# suite: topk (best k of a stream of n ints, ns per item)\n";
+    cout << left << setw(16) << "method" << right << setw(10) << "n" << setw(8) << "k"
+         << setw(10) << "ns" << setw(10) << "allocs" << setw(12) << "held"
+         << setw(22) << "checksum" << '\n';
+    size_t n = options.maxN;
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    vector<int> stream(n);
+    for (int &k : stream)
+        k = key(gen);
+
+    for (size_t k : {10, 1000, 100000})
+    {
+        if (k > n)
+            break;
+        vector<int> out;
+        out.reserve(k);
+        auto sum = [&out]() {
+            long long total = 0;
+            for (size_t i = 0; i < out.size(); ++i)
+                total += static_cast<long long>(i + 1) * out[i];
+            return total;
+        };
+
+        {
+            BoundedPQ<int> best(k);
+            size_t before = allocationCount;
+            Timer timer;
+            for (int x : stream)
+                best.push(x);
+            best.drainSorted(back_inserter(out));
+            double ns = timer.elapsedNs();
+            topkRow("bounded", n, k, ns, allocationCount - before, k, sum());
+        }
+        {
+            out.clear();
+            vector<int> storage;
+            storage.reserve(k);
+            priority_queue<int, vector<int>, greater<int>> best(greater<int>(), move(storage));
+            size_t before = allocationCount;
+            Timer timer;
+            for (int x : stream)
+            {
+                if (best.size() < k)
+                    best.push(x);
+                else if (best.top() < x)
+                {
+                    best.pop();
+                    best.push(x);
+                }
+            }
+            while (!best.empty())
+            {
+                out.push_back(best.top());
+                best.pop();
+            }
+            double ns = timer.elapsedNs();
+            topkRow("std heap of k", n, k, ns, allocationCount - before, k, sum());
+        }
+        {
+            out.clear();
+            BinaryPQ<int> all;
+            size_t before = allocationCount;
+            Timer timer;
+            for (int x : stream)
+                all.push(x);
+            for (size_t i = 0; i < k; ++i)
+                out.push_back(all.popTop());
+            reverse(out.begin(), out.end());
+            double ns = timer.elapsedNs();
+            topkRow("binary of all", n, k, ns, allocationCount - before, n, sum());
+        }
+    } // for
+} // benchTopK()
+
+// Print one row of the drain suite.
+void drainRow(const string &queue, const string &method, size_t n, double ns, long long checksum)
+{
+    cout << left << setw(16) << queue << setw(10) << method << right << setw(10) << n << fixed
+         << setprecision(2) << setw(10) << ns / static_cast<double>(n) << setw(22) << checksum
+         << '\n';
+} // drainRow()
+
+// Fill a queue from 'keys', then empty it into a vector in ascending order,
+// either with n calls to popTop() and a reverse, or with drainSorted().
+// Only the emptying is timed.
+template <typename PQ>
+void drainRun(const string &queue, const vector<int> &keys)
+{
+    vector<int> out;
+    out.reserve(keys.size());
+    auto sum = [&out]() {
+        long long total = 0;
+        for (size_t i = 0; i < out.size(); ++i)
+            total += static_cast<long long>(i + 1) * out[i];
+        return total;
+    };
+
+    {
+        PQ pq(keys.begin(), keys.end());
+        Timer timer;
+        while (!pq.empty())
+            out.push_back(pq.popTop());
+        reverse(out.begin(), out.end());
+        drainRow(queue, "pops", keys.size(), timer.elapsedNs(), sum());
+    }
+    {
+        out.clear();
+        PQ pq(keys.begin(), keys.end());
+        Timer timer;
+        pq.drainSorted(back_inserter(out));
+        drainRow(queue, "drain", keys.size(), timer.elapsedNs(), sum());
+    }
+} // drainRun()
+
+// Empty a full queue in sorted order, popping against drainSorted().  The
+// checksums of each queue's two rows must agree.
+void benchDrain()
+{
+    cout << "# suite: drain (empty a queue of n random ints in order, ns per element)\n";
+    cout << left << setw(16) << "queue" << setw(10) << "method" << right << setw(10) << "n"
+         << setw(10) << "ns" << setw(22) << "checksum" << '\n';
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    for (size_t n = 1000; n <= options.maxN; n *= 100)
+    {
+        vector<int> keys(n);
+        for (int &k : keys)
+            k = key(gen);
+        drainRun<BinaryPQ<int>>("Binary", keys);
+        drainRun<DaryPQ<int, less<int>, 4>>("Dary4", keys);
+        drainRun<PairingPQ<int>>("Pairing", keys);
+        if (n > options.quadraticMaxN)
+            continue;
+        drainRun<SortedPQ<int>>("Sorted", keys);
+        drainRun<UnorderedPQ<int>>("Unordered", keys);
+        drainRun<UnorderedFastPQ<int>>("UnorderedFast", keys);
+    } // for
+} // benchDrain()
+
+// Print one row of the blocked suite.
+void blockedRow(const string &queue, const string &workload, size_t n, double ns, long long checksum)
+{
+    cout << left << setw(16) << queue << setw(10) << workload << right << setw(10) << n << fixed
+         << setprecision(2) << setw(10) << ns / static_cast<double>(n) << setw(22) << checksum
+         << '\n';
+} // blockedRow()
+
+// Time two workloads on a queue of n ints from 'keys': pushing them all and
+// popping them all ("fill"), and, from a full queue, n rounds of a pop and
+// a push of a fresh key ("hold").  Both are per operation.  The checksums
+// depend only on the popped values, so every queue's rows must agree.
+template <typename PQ>
+void blockedRun(const string &queue, const vector<int> &keys)
+{
+    size_t n = keys.size();
+    {
+        PQ pq;
+        long long checksum = 0;
+        Timer timer;
+        for (int k : keys)
+            pq.push(k);
+        for (size_t i = 0; i < n; ++i)
+            checksum += static_cast<long long>(i + 1) * pq.popTop();
+        blockedRow(queue, "fill", 2 * n, timer.elapsedNs(), checksum);
+    }
+    {
+        PQ pq(keys.begin(), keys.end());
+        long long checksum = 0;
+        Timer timer;
+        for (size_t i = 0; i < n; ++i)
+        {
+            int k = pq.popTop();
+            checksum += static_cast<long long>(i + 1) * k;
+            pq.push(k - keys[i] % 1024);
+        }
+        blockedRow(queue, "hold", 2 * n, timer.elapsedNs(), checksum);
+    }
+} // blockedRun()
+
+// Push and pop through BlockedUnorderedPQ at a few block sizes, between
+// BinaryPQ and UnorderedFastPQ, whose pops scan the whole array.
+void benchBlocked()
+{
+    cout << "# suite: blocked (push and pop n random ints, ns per operation)\n";
+    cout << left << setw(16) << "queue" << setw(10) << "workload" << right << setw(10) << "ops"
+         << setw(10) << "ns" << setw(22) << "checksum" << '\n';
+    mt19937 gen(281);
+    uniform_int_distribution<int> key(0, 1 << 30);
+    // Every pop scans at least n / 1024 summaries, so stop at a million.
+    for (size_t n = 1000; n <= min<size_t>(options.maxN, 1000000); n *= 10)
+    {
+        vector<int> keys(n);
+        for (int &k : keys)
+            k = key(gen);
+        blockedRun<BinaryPQ<int>>("Binary", keys);
+        // Past about 16 * BLOCK blocks, a pop is mostly summary scan.
+        if (n <= 16 * 64 * 64)
+            blockedRun<BlockedUnorderedPQ<int, less<int>, 64>>("Blocked64", keys);
+        if (n <= 16 * 256 * 256)
+            blockedRun<BlockedUnorderedPQ<int, less<int>, 256>>("Blocked256", keys);
+        if (n <= 16 * 1024 * 1024)
+            blockedRun<BlockedUnorderedPQ<int, less<int>, 1024>>("Blocked1024", keys);
+        if (n > options.quadraticMaxN)
+            continue;
+        blockedRun<UnorderedFastPQ<int>>("UnorderedFast", keys);
+    } // for
+} // benchBlocked()
+
+// A record somewhere on the heap, a cache line apart from the next, ordered
+// by 'key'.  The keyed suite queues pointers to these.
+struct Remote
+{
+    int key;
+    char padding[60];
+}; // Remote
+
+// Reads of a Remote's key made by the two functors below.
+static size_t remoteReads = 0;
+
+struct RemoteLess
+{
+    bool operator()(const Remote *a, const Remote *b) const
+    {
+        remoteReads += 2;
+        return a->key < b->key;
+    }
+}; // RemoteLess
+
+struct RemoteKey
+{
+    int operator()(const Remote *r) const
+    {
+        ++remoteReads;
+        return r->key;
+    }
+}; // RemoteKey
+
+// Print one row of the keyed suite.
+void keyedRow(const string &queue, const string &phase, size_t n, double ns, size_t reads,
+              const MissCounter &counter, uint64_t misses, long long checksum)
+{
+    double per = static_cast<double>(n);
+    cout << left << setw(12) << queue << setw(10) << phase << right << setw(10) << n << fixed
+         << setprecision(2) << setw(10) << ns / per << setw(10)
+         << static_cast<double>(reads) / per << setw(10);
+    if (counter.available())
+        cout << static_cast<double>(misses) / per;
+    else
+        cout << "-";
+    cout << setw(22) << checksum << '\n';
+} // keyedRow()
+
+// Push n pointers to scattered Remotes, pop half of them, change the key
+// of every tenth Remote and call updatePriorities(), then pop the rest.
+// Each phase is one row; 'reads' counts the key reads per element of the
+// phase and 'misses' the last-level cache misses, where the machine can
+// count them.
+template <typename PQ>
+void keyedRun(const string &queue, vector<Remote> &records, const vector<Remote *> &order)
+{
+    size_t n = order.size();
+    for (size_t i = 0; i < n; ++i)
+        records[i].key = static_cast<int>((i * 2654435761u) % 1000000007u);
+    long long checksum = 0;
+    PQ pq;
+    pq.reserve(n);
+
+    {
+        remoteReads = 0;
+        MissCounter counter;
+        uint64_t before = counter.misses();
+        Timer timer;
+        for (Remote *r : order)
+            pq.push(r);
+        double ns = timer.elapsedNs();
+        keyedRow(queue, "push", n, ns, remoteReads, counter, counter.misses() - before, 0);
+    }
+    {
+        remoteReads = 0;
+        MissCounter counter;
+        uint64_t before = counter.misses();
+        Timer timer;
+        for (size_t i = 0; i < n / 2; ++i)
+            checksum += static_cast<long long>(i + 1) * pq.popTop()->key;
+        double ns = timer.elapsedNs();
+        keyedRow(queue, "pop", n / 2, ns, remoteReads, counter, counter.misses() - before,
+                 checksum);
+    }
+    {
+        for (size_t i = 0; i < n; i += 10)
+            records[i].key = -records[i].key;
+        remoteReads = 0;
+        MissCounter counter;
+        uint64_t before = counter.misses();
+        Timer timer;
+        pq.updatePriorities();
+        double ns = timer.elapsedNs();
+        keyedRow(queue, "update", pq.size(), ns, remoteReads, counter, counter.misses() - before,
+                 0);
+    }
+    {
+        size_t rest = pq.size();
+        remoteReads = 0;
+        MissCounter counter;
+        uint64_t before = counter.misses();
+        Timer timer;
+        for (size_t i = 0; !pq.empty(); ++i)
+            checksum += static_cast<long long>(i + 1) * pq.popTop()->key;
+        double ns = timer.elapsedNs();
+        keyedRow(queue, "pop", rest, ns, remoteReads, counter, counter.misses() - before,
+                 checksum);
+    }
+} // keyedRun()
+
+// Pointers compared through what they point to: BinaryPQ, which follows
+// both pointers on every comparison, against KeyedBinaryPQ, which reads
+// each key once and sifts on a dense copy.  The checksums of matching rows
+// must agree.
+void benchKeyed()
+{
+    cout << "# suite: keyed (pointers to 64-byte records, ns and key reads per element)\n";
+    cout << left << setw(12) << "queue" << setw(10) << "phase" << right << setw(10) << "n"
+         << setw(10) << "ns" << setw(10) << "reads" << setw(10) << "misses" << setw(22)
+         << "checksum" << '\n';
+    for (size_t n = 1000000; n <= options.maxN; n *= 10)
+    {
+        vector<Remote> records(n);
+        vector<Remote *> order;
+        order.reserve(n);
+        for (Remote &r : records)
+            order.push_back(&r);
+        shuffle(order.begin(), order.end(), mt19937(281));
+
+        keyedRun<BinaryPQ<Remote *, RemoteLess>>("Binary", records, order);
+        keyedRun<KeyedBinaryPQ<Remote *, RemoteKey>>("Keyed", records, order);
+        keyedRun<DaryPQ<Remote *, RemoteLess, 4>>("Dary4", records, order);
+        keyedRun<KeyedBinaryPQ<Remote *, RemoteKey, less<int>, 4>>("Keyed4", records, order);
+    } // for
+} // benchKeyed()
+
+// A scheduled task for the cancel suite.  'slot' names the task among the
+// n live ones and breaks ties, so every queue pops the same tasks.
+struct Task
+{
+    int priority;
+    uint32_t slot;
+    uint32_t version;
+}; // Task
+
+struct TaskLess
+{
+    bool operator()(const Task &a, const Task &b) const
+    {
+        return a.priority < b.priority || (a.priority == b.priority && a.slot > b.slot);
+    }
+}; // TaskLess
+
+// One step of the cancel suite.  Every cancelled or popped task is replaced
+// by a new one with priority 'value' in the same slot, so n tasks stay live;
+// an update adds 'value' to the task's priority.
+enum class TaskOp
+{
+    Cancel,
+    Update,
+    Pop
+};
+
+struct TaskStep
+{
+    TaskOp op;
+    uint32_t slot;
+    int value;
+}; // TaskStep
+
+// Print one row of the cancel suite.
+void cancelRow(const string &method, size_t n, size_t ops, double ns, long long checksum)
+{
+    cout << left << setw(16) << method << right << setw(10) << n << fixed << setprecision(2)
+         << setw(12) << ns / static_cast<double>(ops) << setw(22) << checksum << '\n';
+} // cancelRow()
+
+// Run 'steps' against a PairingPQ through erase() and updateElt() on the
+// node of each slot.  Returns the sum of the popped priorities.
+long long cancelPairing(const vector<int> &initial, const vector<TaskStep> &steps)
+{
+    using PQ = PairingPQ<Task, TaskLess>;
+    PQ pq;
+    vector<PQ::Node *> nodes(initial.size());
+    for (uint32_t i = 0; i < initial.size(); ++i)
+        nodes[i] = pq.addNode({initial[i], i, 0});
+
+    long long checksum = 0;
+    for (const TaskStep &step : steps)
+    {
+        uint32_t slot = step.slot;
+        if (step.op == TaskOp::Update)
+        {
+            pq.updateElt(nodes[slot], {nodes[slot]->getElt().priority + step.value, slot, 0});
+            continue;
+        }
+        if (step.op == TaskOp::Cancel)
+            pq.erase(nodes[slot]);
+        else
+        {
+            Task task = pq.popTop();
+            checksum += task.priority;
+            slot = task.slot;
+        }
+        nodes[slot] = pq.addNode({step.value, slot, 0});
+    }
+    return checksum;
+} // cancelPairing()
+
+// The same steps against an IndexedBinaryPQ through its handles.
+long long cancelIndexed(const vector<int> &initial, const vector<TaskStep> &steps)
+{
+    using PQ = IndexedBinaryPQ<Task, TaskLess>;
+    PQ pq;
+    vector<PQ::Handle> handles(initial.size());
+    for (uint32_t i = 0; i < initial.size(); ++i)
+        handles[i] = pq.addElt({initial[i], i, 0});
+
+    long long checksum = 0;
+    for (const TaskStep &step : steps)
+    {
+        uint32_t slot = step.slot;
+        if (step.op == TaskOp::Update)
+        {
+            pq.update(handles[slot], {pq.getElt(handles[slot]).priority + step.value, slot, 0});
+            continue;
+        }
+        if (step.op == TaskOp::Cancel)
+            pq.erase(handles[slot]);
+        else
+        {
+            Task task = pq.popTop();
+            checksum += task.priority;
+            slot = task.slot;
+        }
+        handles[slot] = pq.addElt({step.value, slot, 0});
+    }
+    return checksum;
+} // cancelIndexed()
+
+// The same steps against a BinaryPQ without handles: every cancel or update
+// bumps the slot's version and pushes a fresh entry, and entries whose
+// version is out of date are skipped when they reach the top.
+long long cancelLazy(const vector<int> &initial, const vector<TaskStep> &steps, size_t &peak)
+{
+    BinaryPQ<Task, TaskLess> pq;
+    vector<uint32_t> version(initial.size(), 0);
+    vector<int> priority(initial);
+    for (uint32_t i = 0; i < initial.size(); ++i)
+        pq.push({initial[i], i, 0});
+
+    long long checksum = 0;
+    peak = pq.size();
+    for (const TaskStep &step : steps)
+    {
+        uint32_t slot = step.slot;
+        if (step.op == TaskOp::Pop)
+        {
+            while (pq.top().version != version[pq.top().slot])
+                pq.pop();
+            Task task = pq.popTop();
+            checksum += task.priority;
+            slot = task.slot;
+        }
+        priority[slot] = step.op == TaskOp::Update ? priority[slot] + step.value : step.value;
+        pq.push({priority[slot], slot, ++version[slot]});
+        peak = max(peak, pq.size());
+    }
+    return checksum;
+} // cancelLazy()
+
+// A scheduler that keeps n tasks queued and, at random, cancels one (40%),
+// deprioritizes one (30%), boosts one (10%) or runs the most urgent (20%),
+// refilling every freed slot.  PairingPQ erase()/updateElt() on its nodes
+// against IndexedBinaryPQ handles and against lazy deletion in a BinaryPQ,
+// in ns per step.  The checksum of popped priorities must agree; the lazy
+// row also reports its peak size relative to n.
+void benchCancel()
+{
+    cout << "# suite: cancel (n live tasks, 40% cancel / 40% re-key / 20% pop, ns per step)\n";
+    cout << left << setw(16) << "method" << right << setw(10) << "n" << setw(12) << "ns"
+         << setw(22) << "checksum" << '\n';
+    const size_t ops = 2000000;
+    for (size_t n : {1000, 100000, 1000000})
+    {
+        if (n > options.maxN)
+            break;
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 24);
+        uniform_int_distribution<int> delta(1, 1 << 16);
+        uniform_int_distribution<uint32_t> slot(0, static_cast<uint32_t>(n - 1));
+        uniform_int_distribution<int> kind(0, 9);
+        vector<int> initial(n);
+        for (int &k : initial)
+            k = key(gen);
+        vector<TaskStep> steps(ops);
+        for (TaskStep &step : steps)
+        {
+            int k = kind(gen);
+            step.slot = slot(gen);
+            if (k < 4)
+                step = {TaskOp::Cancel, step.slot, key(gen)};
+            else if (k < 7)
+                step = {TaskOp::Update, step.slot, -delta(gen)};
+            else if (k < 8)
+                step = {TaskOp::Update, step.slot, delta(gen)};
+            else
+                step = {TaskOp::Pop, 0, key(gen)};
+        }
+
+        Timer pairingTimer;
+        long long sum = cancelPairing(initial, steps);
+        cancelRow("pairing", n, ops, pairingTimer.elapsedNs(), sum);
+
+        Timer indexedTimer;
+        sum = cancelIndexed(initial, steps);
+        cancelRow("indexed binary", n, ops, indexedTimer.elapsedNs(), sum);
+
+        size_t peak = 0;
+        Timer lazyTimer;
+        sum = cancelLazy(initial, steps, peak);
+        double ns = lazyTimer.elapsedNs();
+        cancelRow("lazy binary", n, ops, ns, sum);
+        cout << "  lazy binary peak size " << fixed << setprecision(2)
+             << static_cast<double>(peak) / static_cast<double>(n) << " n\n";
+    } // for
+} // benchCancel()
+
+// Push n keys, then pop them all, and print one row of the external suite.
+// 'io' is null for the in-memory queue.
+template <typename PQ>
+void externalRow(const string &name, PQ &pq, const vector<uint64_t> &keys, size_t budget,
+                 const ExternalIOStats *io)
+{
+    resetPeakRss();
+    double count = static_cast<double>(keys.size());
+    Timer pushes;
+    for (uint64_t k : keys)
+        pq.push(k);
+    double pushNs = pushes.elapsedNs() / count;
+
+    uint64_t checksum = 0;
+    Timer pops;
+    while (!pq.empty())
+        checksum = checksum * 31 + pq.popTop();
+    double popNs = pops.elapsedNs() / count;
+
+    const double mib = 1024.0 * 1024.0;
+    cout << left << setw(10) << name << right << setw(10) << keys.size() << fixed << setprecision(1)
+         << setw(8) << static_cast<double>(budget) / mib << setw(10) << pushNs << setw(10) << popNs;
+    if (io)
+        cout << setw(8) << io->runsWritten << setw(8) << io->mergePasses << setw(8) << io->maxRuns
+             << setw(10) << static_cast<double>(io->bytesWritten) / mib
+             << setw(10) << static_cast<double>(io->bytesRead) / mib;
+    else
+        cout << setw(8) << '-' << setw(8) << '-' << setw(8) << '-' << setw(10) << '-' << setw(10) << '-';
+    cout << setw(12) << peakRssKb() << setw(22) << checksum << '\n';
+} // externalRow()
+
+// The external-memory queue holding ten times as many 8-byte keys as its
+// memory budget, against an in-memory BinaryPQ of the same keys.
+void benchExternal()
+{
+    cout << "# suite: external (n pushes then n pops, ns per operation, MiB of I/O)\n";
+    cout << left << setw(10) << "pq" << right << setw(10) << "n" << setw(8) << "budget"
+         << setw(10) << "push-ns" << setw(10) << "pop-ns" << setw(8) << "runs" << setw(8) << "merges"
+         << setw(8) << "max-run" << setw(10) << "written" << setw(10) << "read"
+         << setw(12) << "peak-rss-kb" << setw(22) << "checksum" << '\n';
+    for (size_t budget : {size_t{1} << 20, size_t{4} << 20})
+    {
+        size_t n = min(10 * budget / sizeof(uint64_t), options.maxN);
+        mt19937_64 gen(281);
+        vector<uint64_t> keys(n);
+        for (uint64_t &k : keys)
+            k = gen();
+
+        {
+            BinaryPQ<uint64_t> memory;
+            externalRow("Binary", memory, keys, budget, nullptr);
+        }
+        ExternalPQ<uint64_t> external(budget);
+        externalRow("External", external, keys, budget, &external.ioStats());
+    } // for
+} // benchExternal()
+
+// Print the CountingStats of one queue: a row per operation it was asked to
+// do, with costs per call, then its non-empty histograms.
+void statsRows(const string &name, size_t n, const CountingStats &stats)
+{
+    const pair<PQOp, const char *> ops[] = {{PQOp::Push, "push"}, {PQOp::Pop, "pop"},
+                                            {PQOp::Top, "top"}, {PQOp::Update, "update"},
+                                            {PQOp::Bulk, "bulk"}};
+    for (const auto &op : ops)
+    {
+        const PQOpCounts &counts = stats[op.first];
+        if (counts.calls == 0)
+            continue;
+        double calls = static_cast<double>(counts.calls);
+        cout << left << setw(15) << name << setw(8) << op.second << right << setw(10) << n
+             << setw(10) << counts.calls << fixed << setprecision(2)
+             << setw(12) << static_cast<double>(counts.compares) / calls
+             << setw(10) << static_cast<double>(counts.moves) / calls
+             << setw(10) << static_cast<double>(counts.allocations) / calls
+             << setw(10) << static_cast<double>(counts.siftLevels) / calls << '\n';
+    } // for
+
+    const pair<const PQHistogram *, const char *> histograms[] = {
+        {&stats.siftDepths(), "sift depth"},
+        {&stats.meldWidths(), "meld width"},
+        {&stats.scanLengths(), "scan length"}};
+    for (const auto &h : histograms)
+    {
+        if (h.first->samples() == 0)
+            continue;
+        cout << "#   " << name << ' ' << h.second << ": mean " << fixed << setprecision(2)
+             << h.first->mean() << ", max " << h.first->max() << ", log2 buckets";
+        size_t top = PQHistogram::BUCKETS;
+        while (top > 0 && h.first->bucket(top - 1) == 0)
+            --top;
+        for (size_t b = 0; b < top; ++b)
+            cout << ' ' << h.first->bucket(b);
+        cout << '\n';
+    } // for
+} // statsRows()
+
+// Push n random keys, then alternate top() and pop() until empty, with a
+// counting stats policy, and report what each operation cost.
+template <typename PQ>
+void statsRun(const string &name, const vector<int> &keys)
+{
+    PQ pq;
+    for (int k : keys)
+        pq.push(k);
+    while (!pq.empty())
+    {
+        pq.top();
+        pq.pop();
+    } // while
+    statsRows(name, keys.size(), pq.stats());
+} // statsRun()
+
+// Operation counts from the CountingStats policy for every queue that takes
+// one: comparisons, element moves, node allocations and sift levels per
+// call, and the histograms each queue keeps.
+void benchStats()
+{
+    cout << "# suite: stats (CountingStats, n pushes then n top/pop pairs, per call)\n";
+    cout << left << setw(15) << "pq" << setw(8) << "op" << right << setw(10) << "n"
+         << setw(10) << "calls" << setw(12) << "compares" << setw(10) << "moves"
+         << setw(10) << "allocs" << setw(10) << "levels" << '\n';
+    for (size_t n : {1000, 100000})
+    {
+        mt19937 gen(281);
+        uniform_int_distribution<int> key(0, 1 << 30);
+        vector<int> keys(n);
+        for (int &k : keys)
+            k = key(gen);
+
+        using Less = std::less<int>;
+        statsRun<BinaryPQ<int, Less, 2, CountingStats>>("Binary", keys);
+        statsRun<DaryPQ<int, Less, 4, CountingStats>>("Dary4", keys);
+        statsRun<PairingPQ<int, Less, CountingStats>>("Pairing", keys);
+        if (n > options.quadraticMaxN)
+            continue;
+        statsRun<SortedPQ<int, Less, CountingStats>>("Sorted", keys);
+        statsRun<UnorderedPQ<int, Less, CountingStats>>("Unordered", keys);
+        statsRun<UnorderedFastPQ<int, Less, CountingStats>>("UnorderedFast", keys);
+    } // for
+} // benchStats()
+
+int main(int argc, char *argv[])
+{
+    ios_base::sync_with_stdio(false);
+
+    const vector<pair<string, void (*)()>> suites{
+        {"copies", benchCopies},
+        {"alloc", benchAlloc},
+        {"dary", benchDary},
+        {"sift", benchSift},
+        {"bulk", benchBulk},
+        {"build", benchBuild},
+        {"cancel", benchCancel},
+        {"topk", benchTopK},
+        {"drain", benchDrain},
+        {"blocked", benchBlocked},
+        {"keyed", benchKeyed},
+        {"extreme", benchExtreme},
+        {"dijkstra", benchDijkstra},
+        {"decreasekey", benchDecreaseKey},
+        {"dispatch", benchDispatch},
+        {"multiqueue", benchMultiQueue},
+        {"stats", benchStats},
+        {"external", benchExternal},
+        {"workloads", benchWorkloads}};
+
+    string suite = "all";
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg.compare(0, 8, "--max-n=") == 0)
+            options.maxN = static_cast<size_t>(atof(arg.c_str() + 8));
+        else if (arg.compare(0, 18, "--quadratic-max-n=") == 0)
+            options.quadraticMaxN = static_cast<size_t>(atof(arg.c_str() + 18));
+        else if (arg.compare(0, 9, "--format=") == 0)
+            options.format = arg.substr(9);
+        else
+            suite = arg;
+    } // for
+
+    bool ran = false;
+    for (const auto &entry : suites)
+    {
+        if (suite == "all" || suite == entry.first)
+        {
+            entry.second();
+            ran = true;
+        } // if
+    } // for
+
+    if (!ran)
+    {
+        cout << "usage: " << argv[0] << " [all";
+        for (const auto &entry : suites)
+            cout << '|' << entry.first;
+        cout << "] [--max-n=N] [--quadratic-max-n=N] [--format=csv|json]" << endl;
+        return suite == "help" ? 0 : 1;
+    } // if
+
+    return 0;
+} // main()
@@ -22,15 +22,34 @@
  * You do not have to submit this file, but it won't cause problems if you do.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <forward_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "Eecs281PQ.h"
 #include "BinaryPQ.h"
+#include "BoundedPQ.h"
+#include "ExternalPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "KeyedBinaryPQ.h"
+#include "MultiQueue.h"
 #include "UnorderedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "BlockedUnorderedPQ.h"
 #include "PairingPQ.h"
+#include "PQStats.h"
+#include "RadixPQ.h"
+#include "RankPairingPQ.h"
 #include "SortedPQ.h"
 
 using namespace std;
@@ -72,6 +91,10 @@ void testHiddenData(const string &pqType)
     {
         pq = new UnorderedPQ<HiddenData, HiddenDataComp>;
     } // if
+    else if (pqType == "UnorderedFast")
+    {
+        pq = new UnorderedFastPQ<HiddenData, HiddenDataComp>;
+    }
     else if (pqType == "Sorted")
     {
         pq = new SortedPQ<HiddenData, HiddenDataComp>;
@@ -80,10 +103,26 @@ void testHiddenData(const string &pqType)
     {
         pq = new BinaryPQ<HiddenData, HiddenDataComp>;
     }
+    else if (pqType == "Dary")
+    {
+        pq = new DaryPQ<HiddenData, HiddenDataComp>;
+    }
+    else if (pqType == "Indexed")
+    {
+        pq = new IndexedBinaryPQ<HiddenData, HiddenDataComp>;
+    }
     else if (pqType == "Pairing")
     {
         pq = new PairingPQ<HiddenData, HiddenDataComp>;
     }
+    else if (pqType == "RankPairing")
+    {
+        pq = new RankPairingPQ<HiddenData, HiddenDataComp>;
+    }
+    else if (pqType == "Blocked")
+    {
+        pq = new BlockedUnorderedPQ<HiddenData, HiddenDataComp, 2>;
+    }
 
     pq->push({21});
     pq->push({23});
@@ -142,6 +181,10 @@ void testUpdatePriorities(const string &pqType)
     {
         pq = new UnorderedPQ<int *, IntPtrComp>;
     } // if
+    else if (pqType == "UnorderedFast")
+    {
+        pq = new UnorderedFastPQ<int *, IntPtrComp>;
+    }
     else if (pqType == "Sorted")
     {
         pq = new SortedPQ<int *, IntPtrComp>;
@@ -150,10 +193,26 @@ void testUpdatePriorities(const string &pqType)
     {
         pq = new BinaryPQ<int *, IntPtrComp>;
     }
+    else if (pqType == "Dary")
+    {
+        pq = new DaryPQ<int *, IntPtrComp, 3>;
+    }
+    else if (pqType == "Indexed")
+    {
+        pq = new IndexedBinaryPQ<int *, IntPtrComp>;
+    }
     else if (pqType == "Pairing")
     {
         pq = new PairingPQ<int *, IntPtrComp>;
     }
+    else if (pqType == "RankPairing")
+    {
+        pq = new RankPairingPQ<int *, IntPtrComp>;
+    }
+    else if (pqType == "Blocked")
+    {
+        pq = new BlockedUnorderedPQ<int *, IntPtrComp, 4>;
+    }
 
     if (!pq)
     {
@@ -165,6 +224,962 @@ void testUpdatePriorities(const string &pqType)
     delete pq;
 } // testUpdatePriorities()
 
+// Change every 'step'th key behind the queue's back, some far up, some far
+// down and some in between, let 'update' repair the queue given which keys
+// changed, and check the drain order.
+template <typename PQ, typename UpdateFn>
+void testChangedKeysOn(PQ &pq, vector<int> &keys, size_t step, UpdateFn update)
+{
+    vector<bool> changed(keys.size());
+    for (size_t i = 0; i < keys.size(); i += step)
+    {
+        if (i % 3 == 0)
+            keys[i] += 5000;
+        else if (i % 3 == 1)
+            keys[i] -= 5000;
+        else
+            keys[i] = static_cast<int>(i * 613 % 1000);
+        changed[i] = true;
+    }
+    update(changed);
+
+    size_t count = 0;
+    [[maybe_unused]] int previous = *pq.top();
+    while (!pq.empty())
+    {
+        assert(*pq.top() <= previous);
+        previous = *pq.top();
+        pq.pop();
+        ++count;
+    }
+    assert(count == keys.size());
+} // testChangedKeysOn()
+
+// Test the updatePriorities() overloads that are told which elements changed,
+// with few changes (repaired in place) and many (rebuilt).
+void testUpdateChanged(const string &pqType)
+{
+    cout << "Testing updatePriorities() with changed elements on " << pqType << endl;
+
+    for (size_t step : {97, 10, 1})
+    {
+        vector<int> keys;
+        for (int i = 0; i < 1000; ++i)
+            keys.push_back((i * 37) % 1000);
+        auto isChanged = [&keys](const vector<bool> &changed) {
+            return [&keys, &changed](int *p) { return bool(changed[size_t(p - keys.data())]); };
+        };
+
+        if (pqType == "Unordered")
+        {
+            UnorderedPQ<int *, IntPtrComp> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "UnorderedFast")
+        {
+            UnorderedFastPQ<int *, IntPtrComp> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            pq.top();
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "Sorted")
+        {
+            SortedPQ<int *, IntPtrComp> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "Binary")
+        {
+            BinaryPQ<int *, IntPtrComp> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "Dary")
+        {
+            DaryPQ<int *, IntPtrComp, 3> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "Indexed")
+        {
+            IndexedBinaryPQ<int *, IntPtrComp> pq;
+            vector<IndexedBinaryPQ<int *, IntPtrComp>::Handle> handles;
+            for (int &key : keys)
+                handles.push_back(pq.addElt(&key));
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                vector<IndexedBinaryPQ<int *, IntPtrComp>::Handle> which;
+                for (size_t i = 0; i < changed.size(); ++i)
+                    if (changed[i])
+                        which.push_back(handles[i]);
+                pq.updatePriorities(which);
+            });
+        }
+        else if (pqType == "Pairing")
+        {
+            PairingPQ<int *, IntPtrComp> pq;
+            vector<PairingPQ<int *, IntPtrComp>::Node *> nodes;
+            for (int &key : keys)
+                nodes.push_back(pq.addNode(&key));
+            // Pop and push back a few so the tree is not just a list of
+            // children under the root.
+            for (int i = 0; i < 10; ++i)
+            {
+                int *p = pq.top();
+                pq.pop();
+                nodes[size_t(p - keys.data())] = pq.addNode(p);
+            }
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                vector<PairingPQ<int *, IntPtrComp>::Node *> which;
+                for (size_t i = 0; i < changed.size(); ++i)
+                    if (changed[i])
+                        which.push_back(nodes[i]);
+                pq.updatePriorities(which);
+            });
+        }
+        else if (pqType == "Blocked")
+        {
+            BlockedUnorderedPQ<int *, IntPtrComp, 16> pq;
+            for (int &key : keys)
+                pq.push(&key);
+            pq.top();
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                pq.updatePriorities(isChanged(changed));
+            });
+        }
+        else if (pqType == "RankPairing")
+        {
+            RankPairingPQ<int *, IntPtrComp> pq;
+            vector<RankPairingPQ<int *, IntPtrComp>::Node *> nodes;
+            for (int &key : keys)
+                nodes.push_back(pq.addNode(&key));
+            // Pop and push back a few so the roots are linked into trees.
+            for (int i = 0; i < 10; ++i)
+            {
+                int *p = pq.top();
+                pq.pop();
+                nodes[size_t(p - keys.data())] = pq.addNode(p);
+            }
+            testChangedKeysOn(pq, keys, step, [&](const vector<bool> &changed) {
+                vector<RankPairingPQ<int *, IntPtrComp>::Node *> which;
+                for (size_t i = 0; i < changed.size(); ++i)
+                    if (changed[i])
+                        which.push_back(nodes[i]);
+                pq.updatePriorities(which);
+            });
+        }
+    }
+
+    cout << "testUpdateChanged() succeeded!" << endl;
+} // testUpdateChanged()
+
+// Test push(TYPE &&), emplace() and popTop() with a heavy payload type.
+void testMoveSemantics(const string &pqType)
+{
+    Eecs281PQ<string> *pq = nullptr;
+    cout << "Testing move semantics on " << pqType << endl;
+
+    if (pqType == "Unordered")
+        pq = new UnorderedPQ<string>;
+    else if (pqType == "UnorderedFast")
+        pq = new UnorderedFastPQ<string>;
+    else if (pqType == "Sorted")
+        pq = new SortedPQ<string>;
+    else if (pqType == "Binary")
+        pq = new BinaryPQ<string>;
+    else if (pqType == "Dary")
+        pq = new DaryPQ<string>;
+    else if (pqType == "Indexed")
+        pq = new IndexedBinaryPQ<string>;
+    else if (pqType == "Pairing")
+        pq = new PairingPQ<string>;
+    else if (pqType == "RankPairing")
+        pq = new RankPairingPQ<string>;
+    else if (pqType == "Blocked")
+        pq = new BlockedUnorderedPQ<string, std::less<string>, 2>;
+
+    string banana(40, 'b');
+    pq->push(string(40, 'a'));
+    pq->push(std::move(banana));
+    pq->emplace(40, 'c');
+    assert(pq->size() == 3);
+    assert(pq->top() == string(40, 'c'));
+
+    string largest = pq->popTop();
+    assert(largest == string(40, 'c'));
+    assert(pq->size() == 2);
+    string middle = pq->popTop();
+    assert(middle == string(40, 'b'));
+    string smallest = pq->popTop();
+    assert(smallest == string(40, 'a'));
+    assert(pq->empty());
+
+    cout << "testMoveSemantics() succeeded!" << endl;
+    delete pq;
+} // testMoveSemantics()
+
+// Push batches into a queue that already holds elements through the
+// implementation's own pushRange(), and check the drain order.
+template <typename PQ>
+void testPushRangeOn(PQ &pq)
+{
+    vector<int> small{5, 1, 9};
+    vector<int> large;
+    for (int i = 0; i < 500; ++i)
+        large.push_back((i * 7919) % 1009);
+
+    pq.push(50);
+    pq.pushRange(small.begin(), small.end());
+    assert(pq.size() == 4);
+    assert(pq.top() == 50);
+    pq.pushRange(large.begin(), large.end());
+    pq.pushRange(large.end(), large.end());
+    istringstream in("2000 3 11");
+    pq.pushRange(istream_iterator<int>(in), istream_iterator<int>());
+    assert(pq.size() == 507);
+    assert(pq.top() == 2000);
+
+    size_t count = 0;
+    [[maybe_unused]] int previous = pq.top();
+    while (!pq.empty())
+    {
+        assert(pq.top() <= previous);
+        previous = pq.popTop();
+        ++count;
+    }
+    assert(count == 507);
+} // testPushRangeOn()
+
+void testPushRange(const string &pqType)
+{
+    cout << "Testing pushRange() on " << pqType << endl;
+
+    if (pqType == "Unordered")
+    {
+        UnorderedPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "UnorderedFast")
+    {
+        UnorderedFastPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Sorted")
+    {
+        SortedPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Binary")
+    {
+        BinaryPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Dary")
+    {
+        DaryPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Indexed")
+    {
+        IndexedBinaryPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Pairing")
+    {
+        PairingPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "RankPairing")
+    {
+        RankPairingPQ<int> pq;
+        testPushRangeOn(pq);
+    }
+    else if (pqType == "Blocked")
+    {
+        BlockedUnorderedPQ<int, std::less<int>, 4> pq;
+        testPushRangeOn(pq);
+    }
+
+    cout << "testPushRange() succeeded!" << endl;
+} // testPushRange()
+
+// Merge queues of interleaved values into each other, including into and out
+// of empty queues, and check that the donor is left empty but usable.
+template <typename PQ>
+void testMergeOn(PQ &pq)
+{
+    PQ other, empty;
+    for (int i = 0; i < 200; ++i)
+    {
+        pq.push((i * 37) % 200 * 2);
+        other.push((i * 53) % 200 * 2 + 1);
+    }
+
+    pq.merge(std::move(other));
+    assert(pq.size() == 400);
+    assert(pq.top() == 399);
+    assert(other.empty());
+    pq.merge(std::move(empty));
+    pq.merge(std::move(pq));
+    assert(pq.size() == 400);
+
+    empty.merge(std::move(pq));
+    assert(pq.empty());
+    assert(empty.size() == 400);
+    other.push(1000);
+    other.push(-1);
+    empty.merge(std::move(other));
+    assert(empty.top() == 1000);
+
+    [[maybe_unused]] int got = empty.popTop();
+    assert(got == 1000);
+    for (int expected = 399; expected >= 0; --expected)
+    {
+        got = empty.popTop();
+        assert(got == expected);
+    }
+    got = empty.popTop();
+    assert(got == -1);
+    assert(empty.empty());
+
+    pq.push(7);
+    assert(pq.top() == 7);
+} // testMergeOn()
+
+void testMerge(const string &pqType)
+{
+    cout << "Testing merge() on " << pqType << endl;
+
+    if (pqType == "Unordered")
+    {
+        UnorderedPQ<int> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "UnorderedFast")
+    {
+        UnorderedFastPQ<int> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "Sorted")
+    {
+        SortedPQ<int> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "Binary")
+    {
+        BinaryPQ<int> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "Dary")
+    {
+        DaryPQ<int> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "Indexed")
+    {
+        IndexedBinaryPQ<int> pq;
+        testMergeOn(pq);
+
+        // The receiving heap's handles survive a merge.
+        IndexedBinaryPQ<int> a, b;
+        IndexedBinaryPQ<int>::Handle h = a.addElt(5);
+        a.addElt(3);
+        b.addElt(4);
+        b.addElt(9);
+        a.merge(std::move(b));
+        assert(a.top() == 9);
+        a.update(h, 20);
+        assert(a.topHandle() == h);
+        b.addElt(1);
+        assert(b.size() == 1);
+    }
+    else if (pqType == "Pairing")
+    {
+        PairingPQ<int> pq;
+        testMergeOn(pq);
+
+        // Nodes of the absorbed heap keep working through the merged one,
+        // and the spliced free lists hand their slots out again afterwards.
+        PairingPQ<int> a, b;
+        vector<PairingPQ<int>::Node *> nodes;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.push(2 * i);
+            nodes.push_back(b.addNode(2 * i + 1));
+        }
+        for (int i = 0; i < 50; ++i)
+        {
+            a.pop();
+            b.pop();
+        }
+        a.merge(std::move(b));
+        assert(a.size() == 100);
+        a.updateElt(nodes[10], 500);
+        assert(a.top() == 500);
+        for (int i = 0; i < 300; ++i)
+            a.push(i);
+        [[maybe_unused]] int previous = a.top();
+        while (!a.empty())
+        {
+            assert(a.top() <= previous);
+            previous = a.popTop();
+        }
+        b.push(1);
+        assert(b.top() == 1);
+    }
+    else if (pqType == "Blocked")
+    {
+        BlockedUnorderedPQ<int, std::less<int>, 4> pq;
+        testMergeOn(pq);
+    }
+    else if (pqType == "RankPairing")
+    {
+        RankPairingPQ<int> pq;
+        testMergeOn(pq);
+
+        // Nodes of the absorbed heap keep working through the merged one.
+        RankPairingPQ<int> a, b;
+        vector<RankPairingPQ<int>::Node *> nodes;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.push(2 * i);
+            nodes.push_back(b.addNode(2 * i + 1));
+        }
+        a.pop();
+        b.pop();
+        a.merge(std::move(b));
+        assert(a.size() == 198);
+        a.updateElt(nodes[10], 500);
+        assert(a.top() == 500);
+        [[maybe_unused]] int previous = a.top();
+        while (!a.empty())
+        {
+            assert(a.top() <= previous);
+            previous = a.popTop();
+        }
+    }
+
+    cout << "testMerge() succeeded!" << endl;
+} // testMerge()
+
+// Empty a queue with drainSorted(), with extractSorted(), and with the
+// generic versions reached through an Eecs281PQ, checking each result
+// against a sort of what was pushed, and that the queue can be reused.
+template <typename PQ>
+void testDrainSortedOn(PQ &pq)
+{
+    vector<int> expected;
+    for (int i = 0; i < 500; ++i)
+        expected.push_back((i * 7919) % 211);
+    sort(expected.begin(), expected.end());
+
+    vector<int> drained;
+    pq.pushRange(expected.rbegin(), expected.rend());
+    pq.drainSorted(back_inserter(drained));
+    assert(drained == expected);
+    assert(pq.empty() && pq.size() == 0);
+
+    for (int i = 0; i < 500; ++i)
+        pq.push((i * 7919) % 211);
+    vector<int> extracted = std::move(pq).extractSorted();
+    assert(extracted == expected);
+    assert(pq.empty());
+
+    Eecs281PQ<int> &base = pq;
+    base.push(3);
+    base.push(1);
+    base.push(2);
+    vector<int> fromBase = std::move(base).extractSorted();
+    assert((fromBase == vector<int>{1, 2, 3}));
+    assert(pq.empty());
+    base.push(7);
+    drained.clear();
+    base.drainSorted(back_inserter(drained));
+    assert((drained == vector<int>{7}));
+    assert(pq.empty());
+
+    pq.push(4);
+    pq.push(9);
+    assert(pq.top() == 9);
+    drained.clear();
+    pq.drainSorted(back_inserter(drained));
+    assert((drained == vector<int>{4, 9}));
+} // testDrainSortedOn()
+
+void testDrainSorted(const string &pqType)
+{
+    cout << "Testing drainSorted() and extractSorted() on " << pqType << endl;
+
+    if (pqType == "Unordered")
+    {
+        UnorderedPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "UnorderedFast")
+    {
+        UnorderedFastPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Sorted")
+    {
+        SortedPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Binary")
+    {
+        BinaryPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Dary")
+    {
+        DaryPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Indexed")
+    {
+        IndexedBinaryPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Pairing")
+    {
+        PairingPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "RankPairing")
+    {
+        RankPairingPQ<int> pq;
+        testDrainSortedOn(pq);
+    }
+    else if (pqType == "Blocked")
+    {
+        BlockedUnorderedPQ<int, std::less<int>, 4> pq;
+        testDrainSortedOn(pq);
+    }
+
+    cout << "testDrainSorted() succeeded!" << endl;
+} // testDrainSorted()
+
+// Counts its own calls, so the stats policies can be checked against it.
+struct TallyLess
+{
+    static size_t calls;
+
+    bool operator()(int a, int b) const
+    {
+        ++calls;
+        return a < b;
+    }
+};
+
+size_t TallyLess::calls = 0;
+
+// Push a permutation, pop it back out with a top() before every other pop,
+// and check that CountingStats saw every comparison and charged each to the
+// right operation, then that resetStats() clears it.
+template <typename PQ>
+void testStatsOn(PQ &pq)
+{
+    const int n = 500;
+    TallyLess::calls = 0;
+    for (int i = 0; i < n; ++i)
+        pq.push((i * 211) % n);
+    [[maybe_unused]] size_t pushCompares = TallyLess::calls;
+
+    for (int expected = n - 1; expected >= 0; --expected)
+    {
+        if (expected % 2)
+            assert(pq.top() == expected);
+        [[maybe_unused]] int got = pq.popTop();
+        assert(got == expected);
+    }
+
+    [[maybe_unused]] const CountingStats &stats = pq.stats();
+    assert(stats.total().compares == TallyLess::calls);
+    assert(stats[PQOp::Push].calls == n);
+    assert(stats[PQOp::Push].compares == pushCompares);
+    assert(stats[PQOp::Pop].calls == n);
+    assert(stats[PQOp::Top].calls == n / 2);
+    assert(stats[PQOp::Pop].moves >= n);
+    assert(stats[PQOp::Update].calls == 0);
+
+    vector<int> more{3, 1, 2};
+    pq.pushRange(more.begin(), more.end());
+    assert(stats[PQOp::Bulk].calls == 1);
+    assert(stats[PQOp::Bulk].moves >= 3);
+    pq.updatePriorities();
+    assert(stats[PQOp::Update].calls == 1);
+
+    pq.resetStats();
+    assert(stats.total().calls == 0);
+    assert(stats.total().compares == 0);
+    assert(stats.siftDepths().samples() == 0);
+    assert(stats.meldWidths().samples() == 0);
+    assert(stats.scanLengths().samples() == 0);
+    assert(pq.top() == 3);
+    assert(stats[PQOp::Top].calls == 1);
+} // testStatsOn()
+
+void testStats(const string &pqType)
+{
+    cout << "Testing stats policies on " << pqType << endl;
+
+    if (pqType == "Unordered")
+    {
+        UnorderedPQ<int, TallyLess, CountingStats> pq;
+        testStatsOn(pq);
+
+        // Every pop without a top() before it scans the whole array.
+        UnorderedPQ<int, TallyLess, CountingStats> scan;
+        for (int i = 0; i < 10; ++i)
+            scan.push(i);
+        while (!scan.empty())
+            scan.pop();
+        assert(scan.stats().scanLengths().samples() == 10);
+        assert(scan.stats().scanLengths().total() == 55);
+        assert(scan.stats().scanLengths().max() == 10);
+        assert(scan.stats().scanLengths().bucket(4) == 3);
+        assert(scan.stats()[PQOp::Pop].compares == 45);
+    }
+    else if (pqType == "UnorderedFast")
+    {
+        UnorderedFastPQ<int, TallyLess, CountingStats> pq;
+        testStatsOn(pq);
+
+        // A top() before a pop() saves the pop its scan.
+        assert(pq.stats().scanLengths().samples() == 1);
+        pq.pop();
+        assert(pq.stats().scanLengths().samples() == 1);
+        assert(pq.stats()[PQOp::Pop].compares == 0);
+    }
+    else if (pqType == "Sorted")
+    {
+        SortedPQ<int, TallyLess, CountingStats> pq;
+        testStatsOn(pq);
+        assert(pq.stats()[PQOp::Top].compares == 0);
+    }
+    else if (pqType == "Indexed")
+    {
+        IndexedBinaryPQ<int, TallyLess, 2, CountingStats> pq;
+        testStatsOn(pq);
+
+        // An update sifts only the one element, which here climbs to the
+        // root of a full 63-element heap.
+        IndexedBinaryPQ<int, TallyLess, 2, CountingStats> climb;
+        for (int i = 0; i < 63; ++i)
+            climb.push(i);
+        climb.resetStats();
+        climb.update(climb.topHandle(), -1);
+        climb.update(climb.topHandle(), -2);
+        assert(climb.stats()[PQOp::Update].calls == 2);
+        assert(climb.stats().siftDepths().max() == 5);
+        assert(climb.top() == 60);
+    }
+    else if (pqType == "Binary" || pqType == "Dary")
+    {
+        BinaryPQ<int, TallyLess, 2, CountingStats> pq;
+        testStatsOn(pq);
+
+        // A sorted run pushed into a max-heap climbs to the root every time,
+        // and each pop walks a hole down nearly to the bottom.
+        BinaryPQ<int, TallyLess, 2, CountingStats> climb;
+        for (int i = 0; i < 1023; ++i)
+            climb.push(i);
+        [[maybe_unused]] const CountingStats &stats = climb.stats();
+        assert(stats[PQOp::Push].siftLevels == stats.siftDepths().total());
+        assert(stats.siftDepths().max() == 9);
+        climb.resetStats();
+        climb.pop();
+        assert(stats.siftDepths().samples() == 1);
+        assert(stats.siftDepths().max() >= 8);
+        assert(stats[PQOp::Pop].siftLevels == stats.siftDepths().max());
+
+        DaryPQ<int, TallyLess, 4, CountingStats> dary;
+        testStatsOn(dary);
+    }
+    else if (pqType == "Pairing")
+    {
+        PairingPQ<int, TallyLess, CountingStats> pq;
+        testStatsOn(pq);
+
+        // Pushing onto a larger root makes every node a child of the root,
+        // so the first pop pairs all of them.
+        PairingPQ<int, TallyLess, CountingStats> flat;
+        flat.push(100);
+        for (int i = 0; i < 20; ++i)
+            flat.addNode(i);
+        assert(flat.stats()[PQOp::Push].allocations == 21);
+        flat.pop();
+        assert(flat.stats().meldWidths().samples() == 1);
+        assert(flat.stats().meldWidths().max() == 20);
+        assert(flat.stats()[PQOp::Pop].compares == 19);
+
+        // A copy carries the stats along with the elements.
+        PairingPQ<int, TallyLess, CountingStats> copy(flat);
+        assert(copy.stats()[PQOp::Push].calls == 21);
+    }
+    else if (pqType == "Blocked")
+    {
+        BlockedUnorderedPQ<int, TallyLess, 8, CountingStats> pq;
+        testStatsOn(pq);
+
+        // An ascending run costs a compare per push, bar the first of each
+        // block, and a top() then scans only the eight block summaries.
+        BlockedUnorderedPQ<int, TallyLess, 8, CountingStats> run;
+        for (int i = 0; i < 64; ++i)
+            run.push(i);
+        assert(run.stats()[PQOp::Push].compares == 56);
+        assert(run.top() == 63);
+        assert(run.stats().scanLengths().max() == 8);
+        assert(run.stats()[PQOp::Top].compares == 7);
+
+        // The pop rescans the one block it emptied a slot of, and a push
+        // that wins its block is checked against the known top.
+        run.pop();
+        assert(run.stats().scanLengths().samples() == 2);
+        assert(run.stats().scanLengths().total() == 15);
+        assert(run.top() == 62);
+        run.push(100);
+        assert(run.stats()[PQOp::Push].compares == 58);
+        assert(run.top() == 100);
+        assert(run.stats().scanLengths().samples() == 3);
+    }
+    else if (pqType == "RankPairing")
+    {
+        RankPairingPQ<int, TallyLess, CountingStats> pq;
+        testStatsOn(pq);
+
+        // Pushes only add roots, so the first pop links all of them.
+        RankPairingPQ<int, TallyLess, CountingStats> flat;
+        for (int i = 0; i < 21; ++i)
+            flat.addNode(i);
+        assert(flat.stats()[PQOp::Push].allocations == 21);
+        flat.pop();
+        assert(flat.stats().meldWidths().samples() == 1);
+        assert(flat.stats().meldWidths().max() == 20);
+    }
+    else
+        cout << pqType << " does not take a stats policy" << endl;
+
+    // The no-op policy is what every queue uses by default, and it takes no
+    // space: a queue is its base class and its own members.
+    static_assert(sizeof(BinaryPQ<int>) == sizeof(Eecs281PQ<int>) + sizeof(vector<int>),
+                  "NoStats must not make BinaryPQ bigger");
+    static_assert(sizeof(UnorderedPQ<int>) == sizeof(Eecs281PQ<int>) + sizeof(vector<int>),
+                  "NoStats must not make UnorderedPQ bigger");
+    static_assert(sizeof(SortedPQ<int>) == sizeof(Eecs281PQ<int>) + sizeof(vector<int>),
+                  "NoStats must not make SortedPQ bigger");
+    BinaryPQ<int> plain;
+    plain.push(1);
+    plain.resetStats();
+    const NoStats &none = plain.stats();
+    (void)none;
+
+    cout << "testStats() succeeded!" << endl;
+} // testStats()
+
+// Test the rank-pairing heap's handles against a sorted reference under a
+// random mix of pushes, pops, erases and updates in both directions, then
+// that a decrease-key costs O(1) comparisons, however many nodes are
+// queued, and that copies are independent.
+void testRankPairing()
+{
+    cout << "Testing RankPairingPQ handles" << endl;
+
+    RankPairingPQ<int> pq;
+    vector<RankPairingPQ<int>::Node *> nodes;
+    multiset<int> reference;
+    unsigned state = 281;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 8) % 100000);
+    };
+    for (int step = 0; step < 20000; ++step)
+    {
+        int action = next() % 10;
+        if (action < 4 || nodes.empty())
+        {
+            int val = next();
+            nodes.push_back(pq.addNode(val));
+            reference.insert(val);
+        }
+        else if (action < 6)
+        {
+            size_t i = static_cast<size_t>(next()) % nodes.size();
+            int val = next();
+            reference.erase(reference.find(**nodes[i]));
+            reference.insert(val);
+            pq.updateElt(nodes[i], val);
+        }
+        else if (action < 7)
+        {
+            size_t i = static_cast<size_t>(next()) % nodes.size();
+            reference.erase(reference.find(**nodes[i]));
+            pq.erase(nodes[i]);
+            nodes[i] = nodes.back();
+            nodes.pop_back();
+        }
+        else
+        {
+            int top = pq.top();
+            assert(top == *reference.rbegin());
+            auto found = find_if(nodes.begin(), nodes.end(),
+                                 [&](RankPairingPQ<int>::Node *node) {
+                                     return node->getElt() == top;
+                                 });
+            // Any node with the top value will do; erase() it.
+            pq.erase(*found);
+            reference.erase(prev(reference.end()));
+            *found = nodes.back();
+            nodes.pop_back();
+        }
+        assert(pq.size() == reference.size());
+        if (!reference.empty())
+            assert(pq.top() == *reference.rbegin());
+    }
+
+    RankPairingPQ<int> copy(pq);
+    RankPairingPQ<int> assigned;
+    assigned.push(-5);
+    assigned = pq;
+    pq.updatePriorities();
+    vector<int> expected(reference.begin(), reference.end());
+    vector<int> sorted = std::move(pq).extractSorted();
+    assert(sorted == expected);
+    sorted = std::move(copy).extractSorted();
+    assert(sorted == expected);
+    sorted = std::move(assigned).extractSorted();
+    assert(sorted == expected);
+
+    // A decrease-key compares the new value with the old one, with the
+    // node's parent at most, and with the most extreme root, however deep
+    // the node is.
+    RankPairingPQ<int, TallyLess, CountingStats> big;
+    vector<RankPairingPQ<int, TallyLess, CountingStats>::Node *> handles;
+    for (int i = 0; i < 100000; ++i)
+        handles.push_back(big.addNode(i * 10));
+    big.push(-1);
+    big.pop();
+    big.resetStats();
+    for (size_t i = 0; i < handles.size(); i += 7)
+        big.updateElt(handles[i], 2000000 + static_cast<int>(i));
+    [[maybe_unused]] const PQOpCounts &update = big.stats()[PQOp::Update];
+    assert(update.compares <= 3 * update.calls);
+    [[maybe_unused]] int previous = big.popTop();
+    assert(previous == 2000000 + 99995);
+    while (!big.empty())
+    {
+        assert(big.top() <= previous);
+        previous = big.popTop();
+    }
+
+    cout << "testRankPairing() succeeded!" << endl;
+} // testRankPairing()
+
+// Run a random mix of pushes, pops, tops and bulk pushes through a
+// BlockedUnorderedPQ with blocks of BLOCK elements, checking it against a
+// sorted reference as it grows and shrinks across block boundaries.
+template <size_t BLOCK>
+void testBlockedOn()
+{
+    BlockedUnorderedPQ<int, std::less<int>, BLOCK> pq;
+    multiset<int> reference;
+    unsigned state = 281;
+    auto next = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 8) % 1000);
+    };
+    for (int step = 0; step < 20000; ++step)
+    {
+        // Lean towards pushes in the first half, and pops in the second.
+        int action = next() % 10 + (step < 10000 ? 0 : 3);
+        if (action < 5 || reference.empty())
+        {
+            int val = next();
+            pq.push(val);
+            reference.insert(val);
+        }
+        else if (action < 6)
+        {
+            vector<int> more{next(), next(), next()};
+            pq.pushRange(more.begin(), more.end());
+            reference.insert(more.begin(), more.end());
+        }
+        else if (action < 8)
+            assert(pq.top() == *reference.rbegin());
+        else
+        {
+            [[maybe_unused]] int got = pq.popTop();
+            assert(got == *reference.rbegin());
+            reference.erase(prev(reference.end()));
+        }
+        assert(pq.size() == reference.size());
+    }
+
+    BlockedUnorderedPQ<int, std::less<int>, BLOCK> copy(pq);
+    copy.updatePriorities();
+    vector<int> expected(reference.begin(), reference.end());
+    while (!reference.empty())
+    {
+        [[maybe_unused]] int got = pq.popTop();
+        assert(got == *reference.rbegin());
+        reference.erase(prev(reference.end()));
+    }
+    assert(pq.empty());
+    vector<int> sorted = std::move(copy).extractSorted();
+    assert(sorted == expected);
+} // testBlockedOn()
+
+// Test BlockedUnorderedPQ at block sizes from one element up, then that a
+// pop costs O(BLOCK + n / BLOCK) comparisons rather than O(n).
+void testBlocked()
+{
+    cout << "Testing BlockedUnorderedPQ separately" << endl;
+    testBlockedOn<1>();
+    testBlockedOn<2>();
+    testBlockedOn<3>();
+    testBlockedOn<64>();
+
+    BlockedUnorderedPQ<int, TallyLess, 64, CountingStats> pq;
+    for (int i = 0; i < 4096; ++i)
+        pq.push((i * 1237) % 4096);
+    for (int expected = 4095; expected >= 3996; --expected)
+    {
+        [[maybe_unused]] int got = pq.popTop();
+        assert(got == expected);
+    }
+    [[maybe_unused]] const PQOpCounts &pop = pq.stats()[PQOp::Pop];
+    assert(pop.compares <= 2 * (64 + 4096 / 64) * pop.calls);
+
+    // std::vector<bool> keys take the generic scan.
+    BlockedUnorderedPQ<bool, std::less<bool>, 2> flags;
+    for (bool flag : {false, true, false, true, true})
+        flags.push(flag);
+    vector<bool> popped;
+    while (!flags.empty())
+    {
+        assert(flags.top() == (popped.size() < 3));
+        popped.push_back(flags.popTop());
+    }
+    assert((popped == vector<bool>{true, true, true, false, false}));
+
+    cout << "testBlocked() succeeded!" << endl;
+} // testBlocked()
+
 // Very basic testing.
 void testPriorityQueue(Eecs281PQ<int> *pq, const string &pqType)
 {
@@ -199,6 +1214,804 @@ void testPriorityQueue(Eecs281PQ<int> *pq, const string &pqType)
     cout << "testPriorityQueue() succeeded!" << endl;
 } // testPriorityQueue()
 
+// Build a d-ary heap from a range and check that it drains in order, both
+// through popTop() and through drainSorted().
+template <size_t ARITY>
+void testDaryDrain(const vector<int> &vec)
+{
+    DaryPQ<int, std::less<int>, ARITY> pq(vec.begin(), vec.end());
+    assert(pq.size() == vec.size());
+    [[maybe_unused]] int previous = pq.top();
+    while (!pq.empty())
+    {
+        assert(pq.top() <= previous);
+        previous = pq.popTop();
+    }
+
+    DaryPQ<int, std::less<int>, ARITY> sorted(vec.begin(), vec.end());
+    vector<int> expected(vec);
+    sort(expected.begin(), expected.end());
+    vector<int> drained;
+    sorted.drainSorted(back_inserter(drained));
+    assert(drained == expected);
+    assert(sorted.empty());
+} // testDaryDrain()
+
+// Test the d-ary heap at several arities, including odd ones.
+void testDary()
+{
+    cout << "Testing d-ary heaps separately" << endl;
+    vector<int> vec;
+    for (int i = 0; i < 1000; ++i)
+        vec.push_back((i * 7919) % 1009);
+
+    testDaryDrain<2>(vec);
+    testDaryDrain<3>(vec);
+    testDaryDrain<4>(vec);
+    testDaryDrain<8>(vec);
+
+    cout << "testDary() succeeded" << endl;
+} // testDary()
+
+// Test the handle-based members of IndexedBinaryPQ: update() in both
+// directions and erase() from the middle of the heap.
+template <size_t ARITY>
+void testIndexedOn()
+{
+    IndexedBinaryPQ<int, std::less<int>, ARITY> pq;
+    vector<typename IndexedBinaryPQ<int, std::less<int>, ARITY>::Handle> handles;
+    for (int i = 0; i < 100; ++i)
+        handles.push_back(pq.addElt((i * 37) % 101));
+    assert(pq.top() == 100);
+    assert(pq.getElt(handles[50]) == (50 * 37) % 101);
+
+    pq.update(handles[50], 500);
+    assert(pq.top() == 500);
+    assert(pq.topHandle() == handles[50]);
+    pq.update(handles[50], -1);
+    assert(pq.top() == 100);
+    assert(pq.getElt(handles[50]) == -1);
+
+    pq.erase(handles[10]);
+    pq.erase(pq.topHandle());
+    assert(pq.size() == 98);
+    assert(pq.top() == 99);
+
+    // Handles of popped or erased elements are recycled by later pushes,
+    // and every live handle still refers to its own element.
+    typename IndexedBinaryPQ<int, std::less<int>, ARITY>::Handle h = pq.addElt(1000);
+    assert(pq.getElt(h) == 1000);
+    assert(pq.getElt(handles[20]) == (20 * 37) % 101);
+    pq.erase(h);
+    for (int i = 60; i < 100; i += 3)
+        pq.erase(handles[size_t(i)]);
+    // handles[30] held the 100 erased as the top above.
+    for (int i = 11; i < 60; ++i)
+        if (i != 30 && i != 50)
+            assert(pq.getElt(handles[size_t(i)]) == (i * 37) % 101);
+
+    [[maybe_unused]] int previous = pq.top();
+    while (!pq.empty())
+    {
+        assert(pq.top() <= previous);
+        previous = pq.popTop();
+    }
+    assert(previous == -1);
+} // testIndexedOn()
+
+void testIndexed()
+{
+    cout << "Testing indexed binary heap separately" << endl;
+    testIndexedOn<2>();
+    testIndexedOn<4>();
+    cout << "testIndexed() succeeded" << endl;
+} // testIndexed()
+
+// A comparator the vectorized scan does not recognize, so the generic one is
+// used as a reference.
+template <typename TYPE, typename COMP>
+struct OpaqueComp
+{
+    bool operator()(const TYPE &a, const TYPE &b) const { return COMP()(a, b); }
+}; // OpaqueComp
+
+template <typename TYPE, typename COMP>
+void testExtremeScanOn()
+{
+    for (size_t n : {0, 1, 2, 31, 64, 65, 1023, 1024, 1025, 2500})
+    {
+        vector<TYPE> data;
+        for (size_t i = 0; i < n; ++i)
+            data.push_back(static_cast<TYPE>(static_cast<int>(i * 7919 % 201) - 100));
+        [[maybe_unused]] size_t expected = extremeIndex(data.data(), n, OpaqueComp<TYPE, COMP>());
+        assert(extremeIndex(data.data(), n, COMP()) == expected);
+
+        UnorderedPQ<TYPE, COMP> pq(data.begin(), data.end());
+        UnorderedFastPQ<TYPE, COMP> fast(data.begin(), data.end());
+        while (!pq.empty())
+        {
+            assert(pq.top() == fast.top());
+            [[maybe_unused]] TYPE previous = pq.popTop();
+            fast.pop();
+            assert(pq.empty() || !COMP()(previous, pq.top()));
+        }
+    }
+} // testExtremeScanOn()
+
+// Test the vectorized findExtreme() against the generic scan, including ties
+// (the first equal element wins) and sizes around the block boundaries.
+void testExtremeScan()
+{
+    cout << "Testing vectorized findExtreme()" << endl;
+    testExtremeScanOn<int, std::less<int>>();
+    testExtremeScanOn<long long, std::greater<long long>>();
+    testExtremeScanOn<float, std::less<float>>();
+    testExtremeScanOn<double, std::greater<double>>();
+    testExtremeScanOn<unsigned char, std::less<unsigned char>>();
+
+    // std::vector<bool> has no data(), so bool keys take the generic scan.
+    vector<bool> flags{false, true, false, true};
+    UnorderedPQ<bool> unordered(flags.begin(), flags.end());
+    UnorderedFastPQ<bool> fast(flags.begin(), flags.end());
+    vector<bool> popped;
+    while (!unordered.empty())
+    {
+        assert(unordered.top() == fast.top());
+        popped.push_back(unordered.popTop());
+        fast.pop();
+    }
+    assert((popped == vector<bool>{true, true, false, false}));
+    assert(fast.empty());
+    cout << "testExtremeScan() succeeded!" << endl;
+} // testExtremeScan()
+
+struct FirstKey
+{
+    unsigned operator()(const pair<unsigned, string> &p) const { return p.first; }
+}; // FirstKey
+
+struct DerefKey
+{
+    unsigned operator()(const unsigned *p) const { return *p; }
+}; // DerefKey
+
+// Test the radix heap, which is a min-heap over unsigned keys and so does not
+// fit the generic tests above.
+void testRadix()
+{
+    cout << "Testing radix heap separately" << endl;
+
+    // A simulation loop: every pop schedules later events, some of them
+    // with the same key as the one just popped.
+    RadixPQ<unsigned> pq;
+    BinaryPQ<unsigned, std::greater<unsigned>> reference;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        pq.push(i * 7919 % 1000);
+        reference.push(i * 7919 % 1000);
+    }
+    for (unsigned step = 0; step < 5000; ++step)
+    {
+        assert(pq.size() == reference.size());
+        assert(pq.top() == reference.top());
+        unsigned now = pq.popTop();
+        reference.pop();
+        if (step < 4000)
+            for (unsigned delay : {step % 3, step * 31 % 500, step * 7 % 100000})
+            {
+                pq.push(now + delay);
+                reference.push(now + delay);
+            }
+    }
+    while (!reference.empty())
+    {
+        [[maybe_unused]] unsigned got = pq.popTop();
+        assert(got == reference.top());
+        reference.pop();
+    }
+    assert(pq.empty());
+
+    // After top(), a key below it but not below the last popped one is
+    // still allowed, and becomes the new top.
+    RadixPQ<unsigned> peek;
+    peek.push(10);
+    peek.push(50);
+    peek.pop();
+    peek.push(40);
+    assert(peek.top() == 40);
+    peek.push(20);
+    assert(peek.top() == 20);
+    peek.pop();
+    assert(peek.top() == 40);
+
+    // Keys extracted from (key, payload) pairs; payloads are moved out.
+    RadixPQ<pair<unsigned, string>, FirstKey> events;
+    events.push({30u, "c"});
+    events.push({10u, "a"});
+    events.emplace(20u, "b");
+    assert(events.top().second == "a");
+    pair<unsigned, string> event = events.popTop();
+    assert(event.second == "a");
+    event = events.popTop();
+    assert(event.second == "b");
+    event = events.popTop();
+    assert(event.second == "c");
+    assert(events.empty());
+
+    // Keys behind pointers, changed in both directions.
+    vector<unsigned> keys;
+    for (unsigned i = 0; i < 200; ++i)
+        keys.push_back(100 + i * 37 % 200);
+    RadixPQ<unsigned *, DerefKey> pointers;
+    for (unsigned &key : keys)
+        pointers.push(&key);
+    pointers.pop();
+    keys[5] = 1;
+    keys[6] = 5000;
+    pointers.updatePriorities();
+    assert(*pointers.top() == 1);
+    [[maybe_unused]] unsigned previous = 0;
+    size_t count = 0;
+    while (!pointers.empty())
+    {
+        assert(*pointers.top() >= previous);
+        previous = *pointers.popTop();
+        ++count;
+    }
+    assert(count == 199 && previous == 5000);
+
+    // Drained by decreasing key, after which the smallest key may be
+    // pushed again, as after popping everything.
+    RadixPQ<unsigned> drained;
+    for (unsigned key : {40u, 7u, 300u, 7u, 65u})
+        drained.push(key);
+    drained.pop();
+    vector<unsigned> rest;
+    drained.drainSorted(back_inserter(rest));
+    assert((rest == vector<unsigned>{300, 65, 40, 7}));
+    assert(drained.empty());
+    drained.push(300);
+    assert(drained.top() == 300);
+
+    cout << "testRadix() succeeded!" << endl;
+} // testRadix()
+
+// The key of an int * for KeyedBinaryPQ, counting how often it is called.
+struct IntPtrKey
+{
+    static size_t calls;
+
+    int operator()(const int *p) const
+    {
+        ++calls;
+        return *p;
+    }
+}; // IntPtrKey
+
+size_t IntPtrKey::calls = 0;
+
+// A record compared on one of its fields.
+struct Job
+{
+    int priority;
+    string name;
+}; // Job
+
+struct JobPriority
+{
+    int operator()(const Job &job) const { return job.priority; }
+}; // JobPriority
+
+// Test the key-cached heap against a BinaryPQ over the same pointers, and
+// that updatePriorities() picks up keys changed behind its back.
+void testKeyed()
+{
+    cout << "Testing KeyedBinaryPQ" << endl;
+
+    vector<int> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back((i * 7919) % 1009);
+    KeyedBinaryPQ<int *, IntPtrKey> pq;
+    BinaryPQ<int *, IntPtrComp> reference;
+    IntPtrKey::calls = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pq.push(&values[static_cast<size_t>(i)]);
+        reference.push(&values[static_cast<size_t>(i)]);
+        if (i % 3 == 2)
+        {
+            [[maybe_unused]] int *got = pq.popTop();
+            assert(*got == *reference.top());
+            reference.pop();
+        }
+    }
+    // One key per push, none while sifting.
+    assert(IntPtrKey::calls == 1000);
+    assert(pq.size() == reference.size());
+
+    // A few keys changed, then most of them; each update is one pass.
+    for (size_t i = 0; i < values.size(); i += 97)
+        values[i] = (i % 2) ? -1 - static_cast<int>(i) : 5000 + static_cast<int>(i);
+    IntPtrKey::calls = 0;
+    pq.updatePriorities();
+    reference.updatePriorities();
+    assert(IntPtrKey::calls == pq.size());
+    assert(*pq.top() == *reference.top());
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<int>((i * 31) % 701);
+    pq.updatePriorities();
+    reference.updatePriorities();
+    while (!reference.empty())
+    {
+        assert(*pq.top() == *reference.top());
+        pq.pop();
+        reference.pop();
+    }
+    assert(pq.empty());
+
+    // Records ordered on a field, with a min-heap of arity 4.
+    KeyedBinaryPQ<Job, JobPriority, std::greater<int>, 4> jobs;
+    jobs.push(Job{3, "c"});
+    jobs.emplace(Job{1, "a"});
+    jobs.push(Job{2, "b"});
+    assert(jobs.top().name == "a");
+    Job first = jobs.popTop();
+    assert(first.name == "a");
+    vector<Job> more{{0, "z"}, {7, "g"}, {5, "e"}};
+    jobs.pushRange(more.begin(), more.end());
+    vector<Job> drained;
+    jobs.drainSorted(back_inserter(drained));
+    assert(drained.size() == 5 && jobs.empty());
+    string order;
+    for (const Job &job : drained)
+        order += job.name;
+    assert(order == "gecbz");
+
+    // Built from a range and handed back sorted.
+    vector<int *> pointers;
+    for (int &value : values)
+        pointers.push_back(&value);
+    KeyedBinaryPQ<int *, IntPtrKey> built(pointers.begin(), pointers.end());
+    assert(built.size() == values.size());
+    vector<int *> sorted = std::move(built).extractSorted();
+    assert(built.empty());
+    assert(is_sorted(sorted.begin(), sorted.end(), IntPtrComp()));
+
+    // Merged elements bring their cached keys along.
+    KeyedBinaryPQ<int *, IntPtrKey> odd, even, none;
+    for (size_t i = 0; i < values.size(); ++i)
+        (i % 2 ? odd : even).push(&values[i]);
+    IntPtrKey::calls = 0;
+    none.merge(std::move(odd));
+    none.merge(std::move(even));
+    assert(IntPtrKey::calls == 0);
+    assert(odd.empty() && even.empty() && none.size() == values.size());
+    sorted.clear();
+    none.drainSorted(back_inserter(sorted));
+    assert(sorted.size() == values.size());
+    assert(is_sorted(sorted.begin(), sorted.end(), IntPtrComp()));
+
+    cout << "testKeyed() succeeded!" << endl;
+} // testKeyed()
+
+// Test the concurrent MultiQueue: elements pushed from several threads come
+// out exactly once when popped from several threads, and a single thread
+// sees an order close to the exact one.
+void testMultiQueue()
+{
+    cout << "Testing MultiQueue" << endl;
+    const int THREADS = 4, PER_THREAD = 5000;
+    MultiQueue<int> mq(THREADS);
+    assert(mq.shardCount() == 2 * THREADS);
+
+    vector<thread> workers;
+    for (int t = 0; t < THREADS; ++t)
+        workers.emplace_back([&mq, t]() {
+            for (int i = 0; i < PER_THREAD; ++i)
+                mq.push(t * PER_THREAD + i);
+        });
+    for (thread &worker : workers)
+        worker.join();
+    assert(mq.size() == THREADS * PER_THREAD);
+
+    vector<vector<int>> popped(THREADS);
+    workers.clear();
+    for (int t = 0; t < THREADS; ++t)
+        workers.emplace_back([&mq, &popped, t]() {
+            int val;
+            while (mq.tryPop(val))
+                popped[size_t(t)].push_back(val);
+        });
+    for (thread &worker : workers)
+        worker.join();
+    assert(mq.empty());
+
+    vector<int> all;
+    for (const vector<int> &part : popped)
+        all.insert(all.end(), part.begin(), part.end());
+    sort(all.begin(), all.end());
+    assert(all.size() == size_t(THREADS * PER_THREAD));
+    for (size_t i = 0; i < all.size(); ++i)
+        assert(all[i] == int(i));
+
+    // Single-threaded, every pop is within a few ranks of the true maximum,
+    // and a queue with one shard is exact.
+    MultiQueue<int> relaxed(4), exact(1, 1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        relaxed.push(i * 7919 % 1000);
+        exact.push(i * 7919 % 1000);
+    }
+    int val = 0;
+    for (int expected = 999; expected >= 0; --expected)
+    {
+        [[maybe_unused]] bool ok = exact.tryPop(val);
+        assert(ok && val == expected);
+        ok = relaxed.tryPop(val);
+        assert(ok && val > expected - 200);
+    }
+    [[maybe_unused]] bool ok = relaxed.tryPop(val);
+    assert(!ok);
+    ok = exact.tryPop(val);
+    assert(!ok);
+
+    cout << "testMultiQueue() succeeded!" << endl;
+} // testMultiQueue()
+
+// Keep the best 100 of a stream against a sort of the whole stream, and
+// check that newcomers below the threshold cost exactly one comparison.
+void testBounded()
+{
+    cout << "Testing bounded top-k queue" << endl;
+
+    BoundedPQ<int, TallyLess> best(100);
+    assert(best.empty() && best.capacity() == 100);
+    vector<int> stream;
+    for (int i = 0; i < 10000; ++i)
+    {
+        stream.push_back((i * 7919) % 10007);
+        best.push(stream.back());
+        assert(best.size() == min<size_t>(stream.size(), 100));
+    }
+    assert(best.full());
+
+    TallyLess::calls = 0;
+    [[maybe_unused]] bool accepted = best.push(best.threshold());
+    assert(!accepted);
+    accepted = best.push(-1);
+    assert(!accepted);
+    assert(TallyLess::calls == 2);
+    accepted = best.push(20000);
+    assert(accepted);
+
+    stream.push_back(20000);
+    sort(stream.begin(), stream.end());
+    assert(best.threshold() == stream[stream.size() - 100]);
+    vector<int> kept;
+    best.drainSorted(back_inserter(kept));
+    assert(kept.size() == 100);
+    assert(equal(kept.begin(), kept.end(), stream.end() - 100));
+    assert(best.empty());
+
+    // Smallest three, and a queue that keeps nothing.
+    BoundedPQ<string, greater<string>> smallest(3);
+    for (const char *word : {"pear", "fig", "apple", "kiwi", "date", "banana"})
+        smallest.push(word);
+    vector<string> words;
+    smallest.drainSorted(back_inserter(words));
+    assert((words == vector<string>{"date", "banana", "apple"}));
+    BoundedPQ<int> none(0);
+    [[maybe_unused]] bool pushed = none.push(1);
+    assert(!pushed && none.empty() && none.full());
+
+    cout << "testBounded() succeeded!" << endl;
+} // testBounded()
+
+// Test the external-memory queue with a budget of a few kilobytes, so that
+// it spills many runs and has to merge them, against an in-memory heap.
+void testExternal()
+{
+    cout << "Testing external-memory queue separately" << endl;
+
+    ExternalPQ<int> basic(4096);
+    testPriorityQueue(&basic, "External");
+
+    ExternalPQ<int> pq(4096);
+    BinaryPQ<int> reference;
+    for (int i = 0; i < 30000; ++i)
+    {
+        int val = (i * 7919) % 100003;
+        pq.push(val);
+        reference.push(val);
+        if (i % 3 == 0)
+        {
+            assert(pq.top() == reference.top());
+            [[maybe_unused]] int got = pq.popTop();
+            [[maybe_unused]] int expected = reference.popTop();
+            assert(got == expected);
+        }
+    }
+    assert(pq.size() == reference.size());
+    assert(pq.ioStats().runsWritten > 16);
+    assert(pq.ioStats().mergePasses > 0);
+    assert(pq.ioStats().maxRuns <= 16);
+    while (!reference.empty())
+    {
+        assert(pq.size() == reference.size());
+        assert(pq.top() == reference.top());
+        pq.pop();
+        reference.pop();
+    }
+    assert(pq.empty());
+    assert(pq.ioStats().bytesRead == pq.ioStats().bytesWritten);
+
+    // Pointers are written to disk as they are; the keys they point to can
+    // change, and updatePriorities() sorts everything again.
+    vector<int> keys(5000);
+    vector<int *> pointers;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = static_cast<int>(i * 37 % keys.size());
+        pointers.push_back(&keys[i]);
+    }
+    ExternalPQ<int *, IntPtrComp> indirect(pointers.begin(), pointers.end(), 2048);
+    assert(indirect.ioStats().runsWritten > 0);
+    for (int &key : keys)
+        key = -key;
+    indirect.updatePriorities();
+    [[maybe_unused]] int expected = 0;
+    while (!indirect.empty())
+    {
+        [[maybe_unused]] int *p = indirect.popTop();
+        assert(*p == expected--);
+    }
+    assert(expected == -static_cast<int>(keys.size()));
+
+    // The generic drain, across runs on disk.
+    ExternalPQ<int> spilled(4096);
+    for (int i = 0; i < 5000; ++i)
+        spilled.push((i * 7919) % 5003);
+    vector<int> drained;
+    spilled.drainSorted(back_inserter(drained));
+    assert(drained.size() == 5000 && is_sorted(drained.begin(), drained.end()));
+    assert(spilled.empty());
+
+    // Runs are merged a level at a time, so each element is written a
+    // logarithmic number of times; merging every run each time the limit
+    // was hit wrote these over twenty times each.
+    ExternalPQ<int> levels(4096);
+    const size_t many = 400000;
+    for (size_t i = 0; i < many; ++i)
+        levels.push(static_cast<int>(i * 7919 % 400009));
+    assert(levels.ioStats().mergePasses > 16);
+    assert(levels.ioStats().bytesWritten <= 6 * many * sizeof(int));
+    [[maybe_unused]] int previous = levels.popTop();
+    [[maybe_unused]] size_t count = 1;
+    for (; !levels.empty(); ++count)
+    {
+        assert(levels.top() <= previous);
+        previous = levels.popTop();
+    }
+    assert(count == many);
+
+    cout << "testExternal() succeeded!" << endl;
+} // testExternal()
+
+// Compared on 'key' only, so the order in which equal keys come out of a
+// pairing heap depends on the exact shape of its tree.
+struct Tagged
+{
+    int key;
+    int id;
+};
+
+struct TaggedComp
+{
+    static size_t calls;
+
+    bool operator()(const Tagged &a, const Tagged &b) const
+    {
+        ++calls;
+        return a.key < b.key;
+    }
+};
+
+size_t TaggedComp::calls = 0;
+
+// Copies of a pairing heap must keep the source's tree shape, without
+// comparing anything, and report where each node was copied to.
+void testPairingClone()
+{
+    cout << "Testing PairingPQ cloning" << endl;
+
+    using PQ = PairingPQ<Tagged, TaggedComp>;
+    PQ pq;
+    vector<PQ::Node *> handles;
+    vector<bool> alive(2000, true);
+    for (int i = 0; i < 2000; ++i)
+        handles.push_back(pq.addNode({i * 7919 % 50, i}));
+    for (int i = 0; i < 300; ++i)
+        alive[static_cast<size_t>(pq.popTop().id)] = false;
+    for (size_t i = 0; i < handles.size(); i += 97)
+        if (alive[i])
+            pq.updateElt(handles[i], {handles[i]->getElt().key + 20, static_cast<int>(i)});
+
+    TaggedComp::calls = 0;
+    unordered_map<const PQ::Node *, PQ::Node *> remap;
+    PQ snapshot(pq, [&remap](const PQ::Node *from, PQ::Node *to) { remap[from] = to; });
+    PQ plain(pq);
+    PQ assigned;
+    assigned.push({1, -1});
+    TaggedComp::calls = 0;
+    assigned = pq;
+    assert(TaggedComp::calls == 0);
+    assert(snapshot.size() == pq.size());
+    assert(remap.size() == pq.size());
+
+    // Handles re-targeted at the snapshot work there and leave the
+    // original alone.
+    size_t target = 1999;
+    while (!alive[target])
+        --target;
+    PQ::Node *moved = remap.at(handles[target]);
+    assert(moved->getElt().id == static_cast<int>(target));
+    snapshot.updateElt(moved, {1000, static_cast<int>(target)});
+    assert(snapshot.top().id == static_cast<int>(target));
+    assert(pq.top().key < 1000);
+
+    // assign() remaps as well, and the old contents are gone.
+    size_t reported = 0;
+    PQ other;
+    other.push({5, -5});
+    other.assign(snapshot, [&reported](const PQ::Node *, PQ::Node *) { ++reported; });
+    assert(reported == snapshot.size());
+    assert(other.size() == snapshot.size());
+    assert(other.top().id == static_cast<int>(target));
+
+    // Same shape, so equal keys come out in the same order everywhere.
+    while (!pq.empty())
+    {
+        [[maybe_unused]] int id = pq.popTop().id;
+        [[maybe_unused]] int plainId = plain.popTop().id;
+        [[maybe_unused]] int assignedId = assigned.popTop().id;
+        assert(plainId == id && assignedId == id);
+    }
+    assert(plain.empty() && assigned.empty());
+
+    cout << "testPairingClone() succeeded!" << endl;
+} // testPairingClone()
+
+// The range constructor takes any input iterator and builds the heap with
+// exactly n - 1 comparisons.
+void testPairingBuild()
+{
+    cout << "Testing PairingPQ range construction" << endl;
+
+    const int n = 1000;
+    ostringstream text;
+    list<int> bidirectional;
+    forward_list<int> forward;
+    for (int i = 0; i < n; ++i)
+    {
+        int key = i * 7919 % n;
+        text << key << ' ';
+        bidirectional.push_back(key);
+        forward.push_front(key);
+    }
+
+    istringstream input(text.str());
+    TallyLess::calls = 0;
+    PairingPQ<int, TallyLess> streamed{istream_iterator<int>(input), istream_iterator<int>()};
+    assert(TallyLess::calls == n - 1);
+    TallyLess::calls = 0;
+    PairingPQ<int, TallyLess> listed(bidirectional.begin(), bidirectional.end());
+    assert(TallyLess::calls == n - 1);
+    PairingPQ<int, TallyLess, CountingStats> counted(forward.begin(), forward.end());
+    assert(counted.stats()[PQOp::Bulk].compares == n - 1);
+    assert(counted.stats()[PQOp::Bulk].allocations == n);
+
+    for (int expected = n - 1; expected >= 0; --expected)
+    {
+        [[maybe_unused]] int fromStream = streamed.popTop();
+        [[maybe_unused]] int fromList = listed.popTop();
+        [[maybe_unused]] int fromCount = counted.popTop();
+        assert(fromStream == expected && fromList == expected && fromCount == expected);
+    }
+
+    vector<int> none;
+    PairingPQ<int> empty(none.begin(), none.end());
+    assert(empty.empty());
+    empty.push(4);
+    assert(empty.top() == 4);
+
+    cout << "testPairingBuild() succeeded!" << endl;
+} // testPairingBuild()
+
+// Cancel and re-key handles in both directions against a plain array of the
+// live keys, then check that the comparisons stay within 2 log(n)
+// per operation, as the amortized bounds promise.
+void testPairingHandles()
+{
+    cout << "Testing PairingPQ erase() and updateElt() in both directions" << endl;
+
+    using PQ = PairingPQ<Tagged, TaggedComp, CountingStats>;
+    const int n = 2048;
+    PQ pq;
+    vector<PQ::Node *> handles;
+    vector<int> keys;
+    vector<bool> alive(n, true);
+    for (int i = 0; i < n; ++i)
+    {
+        keys.push_back(i * 7919 % n);
+        handles.push_back(pq.addNode({keys.back(), i}));
+    }
+
+    // A leaf that gets weaker has no children to pair: one comparison.
+    PQ::Node *leaf = pq.addNode({-1, n});
+    pq.resetStats();
+    pq.updateElt(leaf, {-2, n});
+    assert(pq.stats()[PQOp::Update].compares == 1);
+    pq.erase(leaf);
+    assert(pq.size() == static_cast<size_t>(n));
+
+    size_t ops = 0;
+    size_t live = n;
+    unsigned next = 12345;
+    for (int round = 0; round < 8 * n; ++round)
+    {
+        next = next * 1103515245u + 12345u;
+        size_t i = (next >> 8) % n;
+        if (!alive[i])
+            continue;
+
+        if (round % 5 == 0)
+        {
+            pq.erase(handles[i]);
+            alive[i] = false;
+            --live;
+        }
+        else
+        {
+            // Half of the updates weaken the element, half strengthen it.
+            int delta = static_cast<int>((next >> 20) % 64) + 1;
+            keys[i] += round % 2 ? delta : -delta;
+            pq.updateElt(handles[i], {keys[i], static_cast<int>(i)});
+        }
+        ++ops;
+        assert(pq.size() == live);
+
+        if (round % 64 == 0)
+        {
+            int best = numeric_limits<int>::min();
+            for (size_t j = 0; j < alive.size(); ++j)
+                if (alive[j])
+                    best = max(best, keys[j]);
+            assert(pq.top().key == best);
+        }
+    }
+
+    vector<int> expected;
+    for (size_t j = 0; j < alive.size(); ++j)
+        if (alive[j])
+            expected.push_back(keys[j]);
+    sort(expected.begin(), expected.end());
+    while (!expected.empty())
+    {
+        [[maybe_unused]] int got = pq.popTop().key;
+        assert(got == expected.back());
+        expected.pop_back();
+        ++ops;
+    }
+    assert(pq.empty());
+
+    size_t log2n = 0;
+    for (size_t m = n; m > 1; m /= 2)
+        ++log2n;
+    assert(pq.stats().total().compares <= 2 * ops * log2n);
+
+    cout << "testPairingHandles() succeeded!" << endl;
+} // testPairingHandles()
+
 // Test the pairing heap's range-based constructor, copy constructor,
 // and operator=().
 //
@@ -328,6 +2141,32 @@ void testPairing(vector<int> &vec)
     pq10->updateElt(n, 5);
     assert(pq10->top() == 300);
 
+    //Test copying an empty heap
+    PairingPQ<int> *pq11 = new PairingPQ<int>();
+    PairingPQ<int> *pq12 = new PairingPQ<int>(*pq11);
+    assert(pq12->empty());
+
+    //Test pop order and updatePriorities() on a larger heap
+    vector<int> keys;
+    keys.reserve(1000);
+    for (int i = 0; i < 1000; ++i)
+        keys.push_back((i * 7919) % 1009);
+    PairingPQ<int *, IntPtrComp> pq13;
+    for (size_t i = 0; i < keys.size(); ++i)
+        pq13.push(&keys[i]);
+    for (int i = 0; i < 100; ++i)
+        pq13.pop();
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = 1009 - keys[i];
+    pq13.updatePriorities();
+    [[maybe_unused]] int previous = *pq13.top();
+    while (!pq13.empty())
+    {
+        assert(*pq13.top() <= previous);
+        previous = *pq13.top();
+        pq13.pop();
+    }
+
     cout
         << "Calling destructors" << endl;
     delete pq1;
@@ -339,6 +2178,8 @@ void testPairing(vector<int> &vec)
     delete pq7;
     delete pq8;
     delete pq10;
+    delete pq11;
+    delete pq12;
 
     cout << "testPairing() succeeded" << endl;
 } // testPairing()
@@ -347,7 +2188,7 @@ int main()
 {
     // Basic pointer, allocate a new PQ later based on user choice.
     Eecs281PQ<int> *pq;
-    vector<string> types{"Unordered", "Sorted", "Binary", "Pairing"};
+    vector<string> types{"Unordered", "Sorted", "Binary", "Pairing", "UnorderedFast", "Dary", "Indexed", "Radix", "External", "RankPairing", "Blocked"};
     unsigned int choice;
 
     cout << "PQ tester" << endl
@@ -374,6 +2215,40 @@ int main()
     {
         pq = new PairingPQ<int>;
     } // else if
+    else if (choice == 4)
+    {
+        pq = new UnorderedFastPQ<int>;
+    } // else if
+    else if (choice == 5)
+    {
+        pq = new DaryPQ<int, std::less<int>, 8>;
+    } // else if
+    else if (choice == 6)
+    {
+        pq = new IndexedBinaryPQ<int>;
+    } // else if
+    else if (choice == 7)
+    {
+        // The radix heap is a min-heap over unsigned keys, so it only runs
+        // its own tests.
+        testRadix();
+        return 0;
+    } // else if
+    else if (choice == 8)
+    {
+        // The external-memory queue only holds trivially copyable elements,
+        // so it also runs its own tests.
+        testExternal();
+        return 0;
+    } // else if
+    else if (choice == 9)
+    {
+        pq = new RankPairingPQ<int>;
+    } // else if
+    else if (choice == 10)
+    {
+        pq = new BlockedUnorderedPQ<int, std::less<int>, 8>;
+    } // else if
     else
     {
         cout << "Unknown container!" << endl
@@ -383,7 +2258,13 @@ int main()
 
     testPriorityQueue(pq, types[choice]);
     testUpdatePriorities(types[choice]);
+    testUpdateChanged(types[choice]);
     testHiddenData(types[choice]);
+    testMoveSemantics(types[choice]);
+    testPushRange(types[choice]);
+    testMerge(types[choice]);
+    testDrainSorted(types[choice]);
+    testStats(types[choice]);
 
     if (choice == 3)
     {
@@ -391,7 +2272,26 @@ int main()
         vec.push_back(0);
         vec.push_back(1);
         testPairing(vec);
+        testPairingClone();
+        testPairingBuild();
+        testPairingHandles();
     } // if
+    else if (choice == 2)
+    {
+        testMultiQueue();
+        testBounded();
+        testKeyed();
+    } // else if
+    else if (choice == 5)
+        testDary();
+    else if (choice == 6)
+        testIndexed();
+    else if (choice == 9)
+        testRankPairing();
+    else if (choice == 10)
+        testBlocked();
+    if (choice == 0 || choice == 4)
+        testExtremeScan();
 
     // Clean up!
     delete pq;